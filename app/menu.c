@@ -66,6 +66,7 @@ static const char Menu[][14] = {
 	"Scan Resume   ",
 	"Scan LED      ",
 	"List To Scan  ",
+	"Priority Scan ",
 	"Ch In List 1  ",
 	"Ch In List 2  ",
 	"Ch In List 3  ",
@@ -505,6 +506,11 @@ void MENU_AcceptSetting(void)
 		SETTINGS_SaveGlobals();
 		break;
 
+	case MENU_PRIORITY_SCAN:
+		gExtendedSettings.PriorityScan = (gSettingCurrentValue + gSettingIndex) % gSettingMaxValues;
+		SETTINGS_SaveGlobals();
+		break;
+
 	case MENU_CTCSS_DCS:
 		gVfoState[gSettings.CurrentVfo].TX.CodeType = gSettingCodeType;
 		gVfoState[gSettings.CurrentVfo].TX.Code = gSettingCode;
@@ -551,6 +557,7 @@ void MENU_AcceptSetting(void)
 		if (!gExtendedSettings.ScanAll) {
 			gExtendedSettings.CurrentScanList = (gSettingCurrentValue + gSettingIndex) % gSettingMaxValues;
 		}
+		CHANNELS_InvalidateScanCache();
 		SETTINGS_SaveGlobals();
 		break;
 
@@ -623,7 +630,6 @@ void MENU_AcceptSetting(void)
 
 	case MENU_SAVE_CH:
 		CHANNELS_SaveChannel((gSettingCurrentValue + gSettingIndex) % gSettingMaxValues, &gVfoState[gSettings.CurrentVfo]);
-		CHANNELS_CheckFreeChannels();
 		// TODO: This "if" block doesn't exist in the original, but there's a bug where VFO A is cleared by the previous line
 		if (gSettings.WorkMode) {
 			CHANNELS_LoadChannel(gSettings.VfoChNo[0], 0);
@@ -636,7 +642,6 @@ void MENU_AcceptSetting(void)
 	case MENU_DELETE_CH:
 		Channel = (gSettingCurrentValue + gSettingIndex) % gSettingMaxValues;
 		CHANNELS_SaveChannel(Channel, &EmptyChannel);
-		CHANNELS_CheckFreeChannels();
 		if (gSettings.WorkMode) {
 			if (gSettings.VfoChNo[0] == Channel) {
 				gSettings.VfoChNo[0] = CHANNELS_GetChannelUp(Channel, 0);
@@ -950,6 +955,13 @@ void MENU_DrawSetting(void)
 		UI_DrawSettingScanlist(gSettingCurrentValue);
 		break;
 
+	case MENU_PRIORITY_SCAN:
+		gSettingCurrentValue = gExtendedSettings.PriorityScan;
+		gSettingMaxValues = 4;
+		DISPLAY_Fill(0, 159, 1, 55, COLOR_BACKGROUND);
+		UI_DrawSettingPriorityScan(gSettingCurrentValue);
+		break;
+
 	case MENU_SCANLIST_1:
 	case MENU_SCANLIST_2:
 	case MENU_SCANLIST_3:
@@ -1325,6 +1337,10 @@ void MENU_ScrollSetting(uint8_t Key)
 		UI_DrawSettingScanlist(gSettingCurrentValue);
 		break;
 
+	case MENU_PRIORITY_SCAN:
+		UI_DrawSettingPriorityScan(gSettingCurrentValue);
+		break;
+
 	case MENU_BUSY_LOCK:
 		UI_DrawSettingBusyLock(gSettingCurrentValue);
 		break;
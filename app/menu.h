@@ -45,6 +45,7 @@ enum {
 	MENU_SCAN_RESUME,
 	MENU_SCAN_BLINK,
 	MENU_LIST_TO_SCAN,
+	MENU_PRIORITY_SCAN,
 	MENU_SCANLIST_1,
 	MENU_SCANLIST_2,
 	MENU_SCANLIST_3,
@@ -19,6 +19,7 @@
 #include "app/radio.h"
 #include "driver/beep.h"
 #include "driver/bk4819.h"
+#include "driver/crm.h"
 #include "driver/delay.h"
 #include "driver/key.h"
 #include "driver/pins.h"
@@ -54,6 +55,24 @@ FrequencyInfo_t gVfoInfo[2];
 bool gNoaaMode;
 uint16_t gCode;
 
+#ifdef UART_DEBUG
+// BK4819 cost of the tunes since the last RADIO_PrintTuneStats
+static uint32_t TuneCount;
+static uint32_t TuneBus;
+static uint32_t TuneSaved;
+static uint32_t TuneCycles;
+#endif
+
+#ifdef ENABLE_FAST_SCAN_TUNE
+// Set while the BK4819 is in RX from a tune made by the scanner
+static bool bScanRxReady;
+// CSS of the channel the scanner is on has not been programmed yet
+static bool bScanTunePending;
+// 5 MHz squelch table step, band, squelch level, bandwidth and modulation
+// of the last full setup
+static uint32_t ScanTuneKey;
+#endif
+
 static void EnableTxAmp(bool bEnable)
 {
 	if (!bEnable) {
@@ -68,7 +87,7 @@ static void EnableTxAmp(bool bEnable)
 	}
 }
 
-static void TuneCurrentVfo(void)
+static void SelectVfoInfo(void)
 {
 	if (gSettings.RepeaterMode == 2) {
 		// Frequency reversal
@@ -88,6 +107,51 @@ static void TuneCurrentVfo(void)
 		gVfoInfo[gCurrentVfo]  = gMainVfo->RX;
 		gVfoInfo[!gCurrentVfo] = gVfoState[!gCurrentVfo].RX;
 	}
+}
+
+static void SetCurrentCss(void)
+{
+	if (gMainVfo->bMuteEnabled) {
+		CSS_SetCustomCode(gMainVfo->bIs24Bit, gMainVfo->Golay, gMainVfo->bIsNarrow);
+	} else {
+		CSS_SetStandardCode(gVfoInfo[gCurrentVfo].CodeType, gCode, gMainVfo->Encrypt, gMainVfo->bIsNarrow);
+	}
+}
+
+#ifdef ENABLE_FAST_SCAN_TUNE
+static uint32_t GetScanTuneKey(void)
+{
+	return ((gVfoInfo[gCurrentVfo].Frequency / 500000) << 16) | (gCurrentFrequencyBand << 8) | (gSettings.Squelch << 3) | (gMainVfo->bIsNarrow << 2) | gMainVfo->gModulationType;
+}
+
+// Scanner hop: the chip is already in RX, so only the PLL is moved. Squelch,
+// bandwidth and band filter follow when they differ and CSS waits for a carrier.
+static void ScanTuneCurrentVfo(void)
+{
+	uint32_t Key;
+
+	SelectVfoInfo();
+	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+
+	gRadioMode = RADIO_MODE_QUIET;
+	EnableTxAmp(false);
+	BK4819_SetFrequency(gVfoInfo[gCurrentVfo].Frequency);
+	gCode = gVfoInfo[gCurrentVfo].Code;
+	Key = GetScanTuneKey();
+	if (Key != ScanTuneKey) {
+		ScanTuneKey = Key;
+		BK4819_SetSquelch(gMainVfo->bIsNarrow);
+		BK4819_SetFilterBandwidth(gMainVfo->bIsNarrow);
+		BK4819_EnableFilter(true);
+	}
+	BK4819_RetuneRX();
+	bScanTunePending = true;
+}
+#endif
+
+static void TuneCurrentVfo(void)
+{
+	SelectVfoInfo();
 
 	if (!gScannerMode) {
 		gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
@@ -98,21 +162,23 @@ static void TuneCurrentVfo(void)
 	EnableTxAmp(false);
 	BK4819_SetFrequency(gVfoInfo[gCurrentVfo].Frequency);
 	gCode = gVfoInfo[gCurrentVfo].Code;
-	if (gMainVfo->bMuteEnabled) {
-		CSS_SetCustomCode(gMainVfo->bIs24Bit, gMainVfo->Golay, gMainVfo->bIsNarrow);
-	} else {
-		CSS_SetStandardCode(gVfoInfo[gCurrentVfo].CodeType, gCode, gMainVfo->Encrypt, gMainVfo->bIsNarrow);
-	}
-	BK4819_SetSquelchGlitch(gMainVfo->bIsNarrow);
-	BK4819_SetSquelchNoise(gMainVfo->bIsNarrow);
-	BK4819_SetSquelchRSSI(gMainVfo->bIsNarrow);
+	SetCurrentCss();
+	BK4819_SetSquelch(gMainVfo->bIsNarrow);
 	BK4819_EnableRX();
 	BK4819_SetFilterBandwidth(gMainVfo->bIsNarrow);
 	BK4819_EnableFilter(true);
+#ifdef ENABLE_FAST_SCAN_TUNE
+	bScanRxReady = gScannerMode;
+	bScanTunePending = false;
+	ScanTuneKey = GetScanTuneKey();
+#endif
 }
 
 static bool TuneTX(bool bUseMic)
 {
+#ifdef ENABLE_FAST_SCAN_TUNE
+	bScanRxReady = false;
+#endif
 	if (gSettings.RepeaterMode == 2) {
 		gVfoInfo[gCurrentVfo] = gMainVfo->RX;
 	} else if (gSettings.RepeaterMode == 1) {
@@ -178,6 +244,9 @@ static void SpecialRxTxLoop(void)
 
 static void TuneNOAA(void)
 {
+#ifdef ENABLE_FAST_SCAN_TUNE
+	bScanRxReady = false;
+#endif
 	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
 	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
 
@@ -190,9 +259,7 @@ static void TuneNOAA(void)
 		BK4819_WriteRegister(0x51, 0x9400 | gFrequencyBandInfo.CtcssTxGainWide);
 		BK4819_WriteRegister(0x07, 0x152C);
 	}
-	BK4819_SetSquelchGlitch(false);
-	BK4819_SetSquelchNoise(false);
-	BK4819_SetSquelchRSSI(false);
+	BK4819_SetSquelch(false);
 	BK4819_EnableScramble(0);
 	BK4819_EnableCompander(false);
 	BK4819_EnableRX();
@@ -255,21 +322,79 @@ void RADIO_Init(void)
 
 void RADIO_Tune(uint8_t Vfo)
 {
+#ifdef UART_DEBUG
+	const uint32_t Bus = gBK4819_BusTransactions;
+	const uint32_t Saved = gBK4819_SavedTransactions;
+	const uint32_t Cycles = gBK4819_BusCycles;
+#endif
+
 	gMainVfo = &gVfoState[Vfo];
 	if (Vfo != 2) {
 		gNoaaMode = false;
 		gCurrentVfo = Vfo;
+#ifdef ENABLE_FAST_SCAN_TUNE
+		if (gScannerMode && bScanRxReady) {
+			ScanTuneCurrentVfo();
+		} else {
+			TuneCurrentVfo();
+		}
+#else
 		TuneCurrentVfo();
+#endif
 	} else {
 		TuneNOAA();
 	}
+
+#ifdef UART_DEBUG
+	TuneCount++;
+	TuneBus += gBK4819_BusTransactions - Bus;
+	TuneSaved += gBK4819_SavedTransactions - Saved;
+	TuneCycles += gBK4819_BusCycles - Cycles;
+#endif
+}
+
+#ifdef UART_DEBUG
+// Averages per tune, printed by the scanner once a second rather than from
+// every hop
+void RADIO_PrintTuneStats(void)
+{
+	if (TuneCount == 0) {
+		return;
+	}
+	UART_printf("RADIO_Tune x%u BK4819 bus: %u saved: %u time: %u us\r\n", (unsigned int)TuneCount, (unsigned int)(TuneBus / TuneCount), (unsigned int)(TuneSaved / TuneCount), (unsigned int)((TuneCycles / TuneCount) / (gSystemCoreClock / 1000000U)));
+	TuneCount = 0;
+	TuneBus = 0;
+	TuneSaved = 0;
+	TuneCycles = 0;
+}
+#endif
+
+#ifdef ENABLE_FAST_SCAN_TUNE
+void RADIO_CompleteScanTune(void)
+{
+	if (bScanTunePending) {
+		bScanTunePending = false;
+		SetCurrentCss();
+	}
+}
+
+// The scanner stopped: the next tune is a full one and the channel it is
+// on gets its CSS.
+void RADIO_EndScanTune(void)
+{
+	bScanRxReady = false;
+	RADIO_CompleteScanTune();
 }
+#endif
 
 void RADIO_StartRX(void)
 {
 	FM_Disable(FM_MODE_STANDBY);
 	BK4819_StartAudio();
 	if (!gFrequencyDetectMode) {
+		if (gScannerMode) {
+			CHANNELS_CompleteScanChannel();
+		}
 		DTMF_ClearString();
 		DTMF_FSK_InitReceive(0);
 		VOX_Timer = 0;
@@ -383,6 +508,9 @@ void RADIO_Sleep(void)
 	BK4819_WriteRegister(0x30, 0x0000);
 	BK4819_WriteRegister(0x37, 0x1D00);
 	gSaveMode = true;
+#ifdef ENABLE_FAST_SCAN_TUNE
+	bScanRxReady = false;
+#endif
 }
 
 static void PlayRogerBeep(uint8_t Mode)
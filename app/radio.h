@@ -30,6 +30,13 @@ extern uint16_t gCode;
 
 void RADIO_Init(void);
 void RADIO_Tune(uint8_t Vfo);
+#ifdef UART_DEBUG
+void RADIO_PrintTuneStats(void);
+#endif
+#ifdef ENABLE_FAST_SCAN_TUNE
+void RADIO_CompleteScanTune(void);
+void RADIO_EndScanTune(void);
+#endif
 
 void RADIO_StartRX(void);
 void RADIO_EndRX(void);
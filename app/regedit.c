@@ -49,6 +49,7 @@ static uint8_t RegIndex = 1;
 static uint16_t RegValue;
 static uint16_t SettingValue;
 static uint8_t CurrentReg; 
+static uint8_t BarLevel = BAR_LEVEL_UNKNOWN;
 
 void UI_DrawStatusRegedit(uint8_t Vfo, uint32_t Frequency) {
 
@@ -69,28 +70,7 @@ void UI_DrawStatusRegedit(uint8_t Vfo, uint32_t Frequency) {
 
 void UI_DrawBarRegedit(uint8_t Level)
 {
-	uint8_t Y = 10;
-	uint8_t i;
-
-    if (Level < 33) {
-		gColorForeground = COLOR_RGB(31, 62,  0);
-	} else if (Level < 66) {
-		gColorForeground = COLOR_RGB(31, 41,  0);
-	} else {
-		gColorForeground = COLOR_RGB(31, 29,  0);
-	}
-
-	for (i = 0; i < Level; i++) {
-	if (i != 0 && i != 33 && i != 66 && i != 99) {
-			DISPLAY_DrawRectangle1(15 + i, Y, 4, 1, gColorForeground);
-		}
-	}
-
-    for (; Level < 100; Level++) {
-		if (Level != 0 && Level != 33 && Level != 66 && Level != 99) {
-			DISPLAY_DrawRectangle1(15 + Level, Y, 4, 1, gColorBackground);
-		}
-	}
+	UI_DrawLevelBar(15, 10, Level, &BarLevel);
 }
 
 void UI_DrawRxDbmRegedit(bool Clear)
@@ -142,6 +122,7 @@ void RegeditDrawStatusBar(uint8_t Vfo)
 	DISPLAY_Fill(0, 159, 0, 96, COLOR_BACKGROUND);
 	//DISPLAY_DrawRectangle0(0, 82, 160, 1, gSettings.BorderColor);
 	DISPLAY_DrawRectangle0(0, 82, 160, 1, COLOR_GREY);
+	BarLevel = BAR_LEVEL_UNKNOWN;
 
 	UI_DrawStatusRegedit(Vfo, gVfoInfo[Vfo].Frequency);
 }
@@ -268,6 +249,7 @@ void APP_RegEdit(void) {
         	CheckRSSIRegedit();
         } else {
         	UI_DrawSmallString((160 - 14*6)/2, 10, "SQUELCH CLOSED", 14);
+        	BarLevel = BAR_LEVEL_UNKNOWN;
         }
 
         DELAY_WaitMS(100);
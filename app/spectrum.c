@@ -14,29 +14,37 @@
  *     limitations under the License.
  */
 
+#include <string.h>
 #include "misc.h"
 #include "app/spectrum.h"
+#ifdef ENABLE_FM_RADIO
+	#include "app/fm.h"
+#endif
 #include "app/radio.h"
+#include "app/uart.h"
+#include "driver/audio.h"
 #include "driver/bk4819.h"
 #include "driver/delay.h"
 #include "driver/key.h"
 #include "driver/pins.h"
 #include "driver/speaker.h"
+#include "driver/st7735s.h"
+#include "driver/uart.h"
 #include "helper/helper.h"
 #include "helper/inputbox.h"
 #include "radio/channels.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
 #include "ui/main.h"
 
 #ifdef UART_DEBUG
-	#include "driver/uart.h"
 	#include "external/printf/printf.h"
 #endif
 
 uint32_t CurrentFreq;
-uint8_t CurrentFreqIndex;
+uint16_t CurrentFreqIndex;
 uint32_t FreqCenter;
 uint32_t FreqMin;
 uint32_t FreqMax;
@@ -45,9 +53,10 @@ uint8_t CurrentFreqStepIndex;
 uint32_t CurrentFreqStep;
 uint32_t CurrentFreqChangeStep;
 uint8_t CurrentStepCountIndex;
-uint8_t CurrentStepCount;
+uint16_t CurrentStepCount;
+uint8_t ColumnCount;
+uint8_t BinsPerColumn;
 uint16_t CurrentScanDelay;
-uint16_t RssiValue[128] = {0};
 uint16_t SquelchLevel;
 uint8_t bExit;
 uint8_t bRXMode;
@@ -71,6 +80,136 @@ uint8_t COLOR_G;
 uint8_t COLOR_B;
 uint16_t COLOR_BAR;
 
+#define BAR_NOT_DRAWN 0xFF
+
+// What is on screen, so a sweep only repaints the bars that changed
+static uint16_t DrawnSquelchPower;
+static uint16_t DrawnActiveColor;
+static uint8_t DrawnColorMode;
+static uint16_t DrawnStepCount;
+static uint8_t DrawnActiveIndex;
+static uint8_t DrawnTraceMode;
+
+#define WATERFALL_Y 12
+#define WATERFALL_LINES 22
+
+#define SIGNAL_MAX 16
+#define SIGNAL_PROMINENCE 10	// 5 dB over the sweep mean
+#define SIGNAL_SEPARATION 3		// Quiet bins that split two signals
+#define SIGNAL_TIMEOUT_MS 60000
+
+typedef struct {
+	uint32_t Frequency;
+	uint32_t LastSeen;
+	uint16_t Rssi;
+} Signal_t;
+
+// Stream frame: 55 AA, sequence (16), time ms (32), start and step in 10 Hz
+// units (32 each), column count (16), bins per column (8), one 16-bit RSSI
+// per column, CRC-16/CCITT-FALSE over everything after the sync bytes.
+// Multi-byte fields are little endian.
+#define STREAM_HEADER_SIZE 19
+#define STREAM_FRAME_SIZE (STREAM_HEADER_SIZE + (128 * 2) + 2)
+
+typedef struct {
+	// Full resolution sweep, RssiValue holds its max-hold per screen column
+	uint16_t Rssi[1024];
+	uint16_t RssiValue[128];
+	// Bar heights on screen, so a sweep only repaints the bars that changed
+	uint8_t DrawnPower[128];
+	// One line per sweep, two 4-bit column levels per byte
+	uint8_t Waterfall[WATERFALL_LINES][64];
+	// Per bin trace in 1/16 RSSI units, ColumnTrace holds its max per screen column
+	uint16_t Trace[1024];
+	uint16_t ColumnTrace[128];
+	uint8_t DrawnTrace[128];
+	// Signals found by the sweeps, sorted by frequency
+	Signal_t Signals[SIGNAL_MAX];
+	// Only rebuilt once the previous frame has left the UART
+	uint8_t Frame[STREAM_FRAME_SIZE];
+} SpectrumBuffer_t;
+
+// The spectrum app is modal and stops voice playback, so it borrows gFlashBuffer.
+static SpectrumBuffer_t *const Buffer = (SpectrumBuffer_t *)gFlashBuffer;
+static uint8_t WaterfallHead;
+static uint8_t bWaterfall;
+static uint8_t bWaterfallRedraw;
+
+enum {
+	TRACE_LIVE,
+	TRACE_AVERAGE,
+	TRACE_MAX_HOLD,
+	TRACE_MIN_HOLD,
+	TRACE_COUNT,
+};
+
+#define SIDE_KEY_DEBOUNCE 30	// ms a side key must be stable
+
+typedef struct {
+	uint32_t ChangeTime;
+	uint8_t bRaw;
+	uint8_t bPressed;
+} SideKey_t;
+
+#define TRACE_DECAY 8			// Max-hold falls 0.5 RSSI units per sweep
+#define TRACE_FLOOR_MARGIN 10	// Auto squelch above the averaged noise floor
+#define TRACE_AVERAGE_SWEEPS 8	// AVG is a plain mean until then, auto squelch waits for it
+#define COLOR_TRACE COLOR_RGB(31, 0, 31)
+
+static const char TraceStrings[TRACE_COUNT][3] = {
+	"   ",
+	"AVG",
+	"MAX",
+	"MIN",
+};
+
+static uint8_t TraceMode;
+static uint8_t bTraceReset;
+static uint8_t TraceSweeps;
+static SideKey_t SideKey1;
+static SideKey_t SideKey2;
+static uint8_t SignalCount;
+static uint8_t SignalIndex;
+
+// Filled in by the UART interrupt
+static volatile uint8_t bStreamRequest;
+static uint32_t StreamStart;
+static uint8_t StreamStepIndex;
+static uint8_t StreamCountIndex;
+static uint8_t bStreamStop;
+
+static uint8_t bStreaming;
+static uint16_t StreamSequence;
+static volatile uint8_t bSpectrumOpen;
+
+#define ADAPTIVE_DWELL_US 2000	// Full dwell, same as the default scan delay
+#define ADAPTIVE_MARGIN 6		// Bins this far above the last sweep's mean get the full dwell
+#define SETTLE_PROBES 4
+#define SETTLE_POLL_US 50
+#define SETTLE_MARGIN_US 100
+
+static uint8_t bAdaptiveDwell;
+static uint16_t AdaptiveThreshold;
+
+static const uint16_t WaterfallPalette[16] = {
+	COLOR_RGB( 0,  0,  0),
+	COLOR_RGB( 0,  0,  8),
+	COLOR_RGB( 0,  0, 16),
+	COLOR_RGB( 0,  0, 24),
+	COLOR_RGB( 0, 16, 31),
+	COLOR_RGB( 0, 32, 31),
+	COLOR_RGB( 0, 48, 31),
+	COLOR_RGB( 0, 63, 24),
+	COLOR_RGB( 0, 63, 12),
+	COLOR_RGB( 8, 63,  0),
+	COLOR_RGB(16, 63,  0),
+	COLOR_RGB(24, 63,  0),
+	COLOR_RGB(31, 48,  0),
+	COLOR_RGB(31, 32,  0),
+	COLOR_RGB(31, 16,  0),
+	COLOR_RGB(31,  0,  0),
+};
+
 #define SPECTRUM_STEPS_COUNT 16
 static const char StepStrings[SPECTRUM_STEPS_COUNT][5] = {
 	"0.01K",
@@ -91,6 +230,9 @@ static const char StepStrings[SPECTRUM_STEPS_COUNT][5] = {
 	"5.00M"
 };
 
+// Measured PLL and RSSI settle time per step size, 0 until calibrated
+static uint16_t SettleTime[SPECTRUM_STEPS_COUNT];
+
 static const char Mode[4][2] = {
 	"FM",
 	"AM",
@@ -116,6 +258,9 @@ void DrawCurrentFreq(uint16_t Color) {
 }
 
 void DrawLabels(void) {
+#ifdef UART_DEBUG
+	const uint32_t LcdBytes = gLcdBusBytes;
+#endif
 
 	gColorForeground = COLOR_FOREGROUND;
 
@@ -131,24 +276,32 @@ void DrawLabels(void) {
 	
 	gColorForeground = COLOR_FOREGROUND;
 	gShortString[2] = ' ';
-	Int2Ascii(CurrentStepCount, (CurrentStepCount < 100) ? 2 : 3);
-	UI_DrawSmallString(2, 70, gShortString, 3);//Step 16-128
+	gShortString[3] = ' ';
+	Int2Ascii(CurrentStepCount, (CurrentStepCount < 100) ? 2 : (CurrentStepCount < 1000) ? 3 : 4);
+	UI_DrawSmallString(2, 70, gShortString, 4);//Step 16-1024
 	
 	gColorForeground = COLOR_FOREGROUND;
 	UI_DrawSmallString(2, 60, StepStrings[CurrentFreqStepIndex], 5);//Step Index
 
 	gColorForeground = COLOR_FOREGROUND;
-	Int2Ascii(CurrentScanDelay, (CurrentScanDelay < 10) ? 1 : 2);
-	if (CurrentScanDelay < 10) {
-		gShortString[1] = gShortString[0];
-		gShortString[0] = ' ';
+	if (bAdaptiveDwell) {
+		UI_DrawSmallString(128, 70, "AU", 2);// Adaptive dwell
+	} else {
+		Int2Ascii(CurrentScanDelay, (CurrentScanDelay < 10) ? 1 : 2);
+		if (CurrentScanDelay < 10) {
+			gShortString[1] = gShortString[0];
+			gShortString[0] = ' ';
+		}
+		UI_DrawSmallString(128, 70, gShortString, 2);// Srch delay
 	}
-	UI_DrawSmallString(128, 70, gShortString, 2);// Srch delay
 
 	gColorForeground = COLOR_FOREGROUND;
 	UI_DrawSmallString(146, 70, (bFilterEnabled) ? "F" : "X", 1);//Filter
 	gColorForeground = COLOR_FOREGROUND;
 	UI_DrawSmallString(128, 60, (bNarrow) ? "12.5K" : "25.0K", 5);// Bandwidth N/W
+
+	gColorForeground = COLOR_TRACE;
+	UI_DrawSmallString(33, 60, TraceStrings[TraceMode], 3);// Trace mode
 	
 	gColorForeground = COLOR_GREY;
 	UI_DrawSmallString(61, 86, (bHold) ? "<HOLD>" : "SEARCH", 6);// Hold/Srch
@@ -159,6 +312,47 @@ void DrawLabels(void) {
 	ShiftShortStringRight(0, 5);
 	gShortString[1] = '.';
 	UI_DrawSmallString(64, 2, gShortString, 6);// Centre step
+
+#ifdef UART_DEBUG
+	UART_printf("DrawLabels LCD bytes: %u\r\n", (unsigned int)(gLcdBusBytes - LcdBytes));
+#endif
+}
+
+void DrawSweepInfo(uint32_t SweepTime) {
+	uint16_t Rate = 0;
+
+	gColorForeground = COLOR_GREY;
+	if (SweepTime) {
+		Rate = 10000 / SweepTime;
+	}
+	if (Rate > 999) {
+		Rate = 999;
+	}
+	Int2Ascii(Rate, 3);
+	gShortString[4] = '/';
+	gShortString[3] = gShortString[2];
+	gShortString[2] = '.';
+	gShortString[5] = 'S';
+	UI_DrawSmallString(2, 86, gShortString, 6);// Sweeps per second
+
+	Int2Ascii((CurrentStepCount * sizeof(Buffer->Rssi[0]))
+		+ ((bWaterfall) ? sizeof(Buffer->Waterfall) : 0)
+		+ ((TraceMode != TRACE_LIVE) ? CurrentStepCount * sizeof(Buffer->Trace[0]) : 0), 4);
+	gShortString[4] = 'B';
+	UI_DrawSmallString(104, 86, gShortString, 5);// Buffer in use
+
+	gColorForeground = COLOR_TRACE;
+	Int2Ascii(SignalCount, 2);
+	gShortString[2] = gShortString[1];
+	gShortString[1] = gShortString[0];
+	gShortString[0] = '#';
+	UI_DrawSmallString(30, 70, gShortString, 3);// Signals found
+}
+
+void ClearWaterfall(void) {
+	memset(Buffer->Waterfall, 0, sizeof(Buffer->Waterfall));
+	WaterfallHead = 0;
+	bWaterfallRedraw = TRUE;
 }
 
 void SetFreqMinMax(void) {
@@ -167,12 +361,21 @@ void SetFreqMinMax(void) {
 	FreqMax = FreqCenter + CurrentFreqChangeStep;
 	FREQUENCY_SelectBand(FreqCenter);
 	BK4819_EnableFilter(bFilterEnabled);
-	RssiValue[CurrentFreqIndex] = 0; // Force a rescan
+	Buffer->Rssi[CurrentFreqIndex] = 0; // Force a rescan
+	ClearWaterfall();
+	bTraceReset = TRUE;
+	bRestartScan = TRUE;
+	AdaptiveThreshold = 0;
+	SignalCount = 0;
+	SignalIndex = SIGNAL_MAX;
 }
 
 void SetStepCount(void) {
-	CurrentStepCount = 128 >> CurrentStepCountIndex;
-	BarWidth = 128 / CurrentStepCount;
+	CurrentStepCount = 1024 >> CurrentStepCountIndex;
+	ColumnCount = (CurrentStepCount > 128) ? 128 : CurrentStepCount;
+	BinsPerColumn = CurrentStepCount / ColumnCount;
+	BarWidth = 128 / ColumnCount;
+	CurrentFreqIndex %= CurrentStepCount;
 }
 
 void IncrementStepIndex(void) {
@@ -197,10 +400,79 @@ void DecrementFreqStepIndex(void) {
 }
 
 void IncrementScanDelay(void) {
-	CurrentScanDelay = (CurrentScanDelay + 2) % 13;
+	// Adaptive dwell sits after the longest fixed delay
+	if (!bAdaptiveDwell && CurrentScanDelay == 12) {
+		bAdaptiveDwell = TRUE;
+		AdaptiveThreshold = 0;
+	} else {
+		bAdaptiveDwell = FALSE;
+		CurrentScanDelay = (CurrentScanDelay + 2) % 13;
+	}
 	DrawLabels();
 }
 
+// Tunes a few bins one step away from their neighbour, as a sweep does, and
+// times how long the RSSI takes to stop moving.
+static void CalibrateSettle(void) {
+	uint16_t Settle = 0;
+
+	for (uint8_t p = 0; p < SETTLE_PROBES; p++) {
+		const uint32_t Freq = FreqMin + ((p * CurrentStepCount / SETTLE_PROBES) + 1) * CurrentFreqStep;
+		uint16_t SettledAt = ADAPTIVE_DWELL_US;
+		uint16_t Elapsed = 0;
+		uint8_t Stable = 0;
+		uint16_t Last;
+		uint16_t Rssi;
+
+		BK4819_set_rf_frequency(Freq - CurrentFreqStep, TRUE);
+		DELAY_WaitUS(ADAPTIVE_DWELL_US);
+		BK4819_set_rf_frequency(Freq, TRUE);
+		Last = BK4819_GetRSSI();
+		while (Elapsed < ADAPTIVE_DWELL_US) {
+			DELAY_WaitUS(SETTLE_POLL_US);
+			Elapsed += SETTLE_POLL_US;
+			Rssi = BK4819_GetRSSI();
+			if (Rssi + 1 >= Last && Rssi <= Last + 1) {
+				if (Stable++ == 0) {
+					SettledAt = Elapsed;
+				}
+				if (Stable == 3) {
+					break;
+				}
+			} else {
+				Stable = 0;
+				SettledAt = ADAPTIVE_DWELL_US;
+			}
+			Last = Rssi;
+		}
+		if (SettledAt > Settle) {
+			Settle = SettledAt;
+		}
+	}
+
+	Settle += SETTLE_MARGIN_US;
+	if (Settle > ADAPTIVE_DWELL_US) {
+		Settle = ADAPTIVE_DWELL_US;
+	}
+	SettleTime[CurrentFreqStepIndex] = Settle;
+}
+
+// Short first read, then the full dwell only on bins that look busy now or
+// did on the last sweep.
+static uint16_t ReadAdaptive(uint16_t i) {
+	const uint16_t Settle = SettleTime[CurrentFreqStepIndex];
+	uint16_t Rssi;
+
+	DELAY_WaitUS(Settle);
+	Rssi = BK4819_GetRSSI();
+	if (Rssi > AdaptiveThreshold || Buffer->Rssi[i] > AdaptiveThreshold) {
+		DELAY_WaitUS(ADAPTIVE_DWELL_US - Settle);
+		Rssi = BK4819_GetRSSI();
+	}
+
+	return Rssi;
+}
+
 void ChangeCenterFreq(uint8_t Up) {
 	if (Up) {
 		FreqCenter += CurrentFreqChangeStep;
@@ -290,93 +562,478 @@ void ChangeSpectrumColor(void) {
 	SpectrumColorMode = (SpectrumColorMode + 1) % 4;
 }
 
+void ToggleWaterfall(void) {
+	bWaterfall ^= 1;
+	if (bWaterfall) {
+		BarY = WATERFALL_Y + WATERFALL_LINES + 1;
+		BarScale = 20;
+	} else {
+		BarY = 15;
+		BarScale = 40;
+	}
+	ClearWaterfall();
+	// From 14 to also clear the newest line marker
+	DISPLAY_Fill(14, 143, WATERFALL_Y, 55, COLOR_BACKGROUND);
+	DrawnStepCount = 0;
+}
+
+void IncrementTraceMode(void) {
+	TraceMode = (TraceMode + 1) % TRACE_COUNT;
+	bTraceReset = TRUE;
+	bRestartScan = TRUE;
+	if (TraceMode == TRACE_AVERAGE) {
+		bResetSquelch = TRUE;
+	}
+	DrawLabels();
+}
+
+static uint16_t UpdateTrace(uint16_t i, uint16_t Rssi, uint8_t bSeed) {
+	const uint16_t Level = Rssi << 4;
+	uint16_t Trace = Buffer->Trace[i];
+
+	if (bSeed) {
+		Trace = Level;
+	} else if (TraceMode == TRACE_AVERAGE) {
+		const uint16_t Weight = TraceSweeps + 1;
+
+		Trace = ((Trace * (Weight - 1)) + Level) / Weight;
+	} else if (TraceMode == TRACE_MAX_HOLD) {
+		Trace = (Trace > TRACE_DECAY) ? Trace - TRACE_DECAY : 0;
+		if (Level > Trace) {
+			Trace = Level;
+		}
+	} else if (Level < Trace) {
+		Trace = Level;
+	}
+	Buffer->Trace[i] = Trace;
+
+	return Trace;
+}
+
+static uint16_t GetNoiseFloor(void) {
+	uint32_t Sum = 0;
+
+	for (uint16_t i = 0; i < CurrentStepCount; i++) {
+		Sum += Buffer->Trace[i];
+	}
+
+	return (Sum / CurrentStepCount) >> 4;
+}
+
+static void RemoveSignal(uint8_t i) {
+	SignalCount--;
+	memmove(&Buffer->Signals[i], &Buffer->Signals[i + 1], (SignalCount - i) * sizeof(Signal_t));
+	if (SignalIndex != SIGNAL_MAX && SignalIndex >= SignalCount) {
+		SignalIndex = SIGNAL_MAX;
+	}
+}
+
+static void AddSignal(uint16_t Bin, uint16_t Rssi, uint32_t Now) {
+	const uint32_t Frequency = FreqMin + (Bin * CurrentFreqStep);
+	const uint32_t Window = SIGNAL_SEPARATION * CurrentFreqStep;
+	uint8_t Oldest = 0;
+	uint8_t i;
+
+	for (i = 0; i < SignalCount; i++) {
+		Signal_t *pSignal = &Buffer->Signals[i];
+
+		if (Frequency + Window >= pSignal->Frequency && Frequency <= pSignal->Frequency + Window) {
+			pSignal->Rssi = Rssi;
+			pSignal->LastSeen = Now;
+			return;
+		}
+		if (pSignal->Frequency > Frequency) {
+			break;
+		}
+	}
+
+	if (SignalCount == SIGNAL_MAX) {
+		// Make room by dropping the stalest entry, or the weakest of this sweep
+		for (uint8_t j = 1; j < SIGNAL_MAX; j++) {
+			if (Buffer->Signals[j].LastSeen < Buffer->Signals[Oldest].LastSeen
+				|| (Buffer->Signals[j].LastSeen == Buffer->Signals[Oldest].LastSeen && Buffer->Signals[j].Rssi < Buffer->Signals[Oldest].Rssi)) {
+				Oldest = j;
+			}
+		}
+		if (Buffer->Signals[Oldest].LastSeen == Now && Buffer->Signals[Oldest].Rssi >= Rssi) {
+			return;
+		}
+		RemoveSignal(Oldest);
+		if (Oldest < i) {
+			i--;
+		}
+	}
+
+	memmove(&Buffer->Signals[i + 1], &Buffer->Signals[i], (SignalCount - i) * sizeof(Signal_t));
+	Buffer->Signals[i].Frequency = Frequency;
+	Buffer->Signals[i].LastSeen = Now;
+	Buffer->Signals[i].Rssi = Rssi;
+	SignalCount++;
+}
+
+// Single pass over the sweep: bins above the threshold form a cluster until
+// SIGNAL_SEPARATION quiet bins in a row close it, and its strongest bin is kept.
+static void FindSignals(uint16_t Floor) {
+	const uint16_t Threshold = Floor + SIGNAL_PROMINENCE;
+	const uint32_t Now = gTimeSinceBoot;
+	uint16_t PeakBin = 0;
+	uint16_t PeakRssi = 0;
+	uint8_t Gap = SIGNAL_SEPARATION;
+	uint8_t i = 0;
+
+	while (i < SignalCount) {
+		if (Now - Buffer->Signals[i].LastSeen > SIGNAL_TIMEOUT_MS) {
+			RemoveSignal(i);
+		} else {
+			i++;
+		}
+	}
+
+	for (uint16_t Bin = 0; Bin < CurrentStepCount; Bin++) {
+		const uint16_t Rssi = Buffer->Rssi[Bin];
+
+		if (Rssi >= Threshold) {
+			if (Gap >= SIGNAL_SEPARATION || Rssi > PeakRssi) {
+				PeakBin = Bin;
+				PeakRssi = Rssi;
+			}
+			Gap = 0;
+		} else if (Gap < SIGNAL_SEPARATION && ++Gap == SIGNAL_SEPARATION) {
+			AddSignal(PeakBin, PeakRssi, Now);
+		}
+	}
+	if (Gap < SIGNAL_SEPARATION) {
+		AddSignal(PeakBin, PeakRssi, Now);
+	}
+}
+
+// Holds on the next found signal, Menu then sends it to the VFO.
+void SelectNextSignal(void) {
+	const Signal_t *pSignal;
+
+	if (SignalCount == 0) {
+		return;
+	}
+	SignalIndex = (SignalIndex + 1 >= SignalCount) ? 0 : SignalIndex + 1;
+	pSignal = &Buffer->Signals[SignalIndex];
+	CurrentFreq = pSignal->Frequency;
+	CurrentFreqIndex = (CurrentFreq - FreqMin) / CurrentFreqStep;
+	bHold = TRUE;
+
+#ifdef UART_DEBUG
+	UART_printf("Signal %u/%u: %u RSSI %u seen %us ago\r\n",
+		(unsigned int)SignalIndex + 1, (unsigned int)SignalCount,
+		(unsigned int)pSignal->Frequency, (unsigned int)pSignal->Rssi,
+		(unsigned int)((gTimeSinceBoot - pSignal->LastSeen) / 1000));
+#endif
+
+	DrawLabels();
+	DrawCurrentFreq(COLOR_FOREGROUND);
+}
+
+// A stream only opens the spectrum over an idle main screen.
+static bool CanOpenSpectrum(void) {
+	return gScreenMode == SCREEN_MAIN && gRadioMode == RADIO_MODE_QUIET && !gScannerMode
+		&& !gFrequencyDetectMode && !gMonitorMode && !gDTMF_InputMode && gInputBoxWriteIndex == 0
+#ifdef ENABLE_FM_RADIO
+		&& gFM_Mode == FM_MODE_OFF
+#endif
+		;
+}
+
+bool APP_SpectrumRequestStream(uint32_t Start, uint32_t Step, uint16_t Count) {
+	uint8_t StepIndex;
+	uint8_t CountIndex;
+
+	if (Count == 0) {
+		bStreamStop = TRUE;
+		bStreamRequest = TRUE;
+		return true;
+	}
+	if (!bSpectrumOpen && !CanOpenSpectrum()) {
+		return false;
+	}
+	for (StepIndex = 0; StepIndex < SPECTRUM_STEPS_COUNT; StepIndex++) {
+		if (FREQUENCY_GetStep(StepIndex) == Step) {
+			break;
+		}
+	}
+	for (CountIndex = 0; CountIndex < STEPS_COUNT; CountIndex++) {
+		if ((1024U >> CountIndex) == Count) {
+			break;
+		}
+	}
+	if (StepIndex == SPECTRUM_STEPS_COUNT || CountIndex == STEPS_COUNT) {
+		return false;
+	}
+
+	StreamStart = Start;
+	StreamStepIndex = StepIndex;
+	StreamCountIndex = CountIndex;
+	bStreamStop = FALSE;
+	bStreamRequest = TRUE;
+
+	return true;
+}
+
+static void ApplyStreamRequest(void) {
+	bStreamRequest = FALSE;
+	if (bStreamStop) {
+		bStreaming = FALSE;
+		return;
+	}
+
+	CurrentFreqStepIndex = StreamStepIndex;
+	CurrentFreqStep = FREQUENCY_GetStep(CurrentFreqStepIndex);
+	CurrentStepCountIndex = StreamCountIndex;
+	SetStepCount();
+	FreqCenter = StreamStart + (CurrentFreqStep * (CurrentStepCount >> 1));
+	SetFreqMinMax();
+	DrawLabels();
+	bStreaming = TRUE;
+}
+
+static uint8_t *PutLE(uint8_t *p, uint32_t Value, uint8_t Size) {
+	while (Size--) {
+		*p++ = Value;
+		Value >>= 8;
+	}
+
+	return p;
+}
+
+// A frame still going out is never waited for: the sweep goes on and the
+// skipped sequence number tells the host a sweep was dropped.
+static void SendStreamFrame(void) {
+	uint8_t *p = Buffer->Frame;
+	uint16_t Crc;
+
+	if (UART_IsSending()) {
+		StreamSequence++;
+		return;
+	}
+
+	*p++ = 0x55;
+	*p++ = 0xAA;
+	p = PutLE(p, StreamSequence++, 2);
+	p = PutLE(p, gTimeSinceBoot, 4);
+	p = PutLE(p, FreqMin, 4);
+	p = PutLE(p, CurrentFreqStep, 4);
+	p = PutLE(p, ColumnCount, 2);
+	p = PutLE(p, BinsPerColumn, 1);
+	for (uint8_t i = 0; i < ColumnCount; i++) {
+		p = PutLE(p, Buffer->RssiValue[i], 2);
+	}
+	Crc = CRC16_Calculate(Buffer->Frame + 2, p - Buffer->Frame - 2);
+	p = PutLE(p, Crc, 2);
+
+	UART_SendAsync(Buffer->Frame, p - Buffer->Frame);
+}
+
+// Opens the spectrum for a stream requested over the UART, once the radio is
+// back to idle if it got busy since the request was acked.
+void APP_SpectrumCheckStream(void) {
+	if (!bStreamRequest) {
+		return;
+	}
+	if (bStreamStop) {
+		bStreamRequest = FALSE;
+		return;
+	}
+	if (CanOpenSpectrum()) {
+		APP_Spectrum();
+	}
+}
+
+static void GetBarRange(uint8_t *pLow, uint8_t *pHigh) {
+	*pLow = RssiLow - 2;
+	if ((RssiHigh - RssiLow) < 40) {
+		*pHigh = RssiLow + 40;
+	} else {
+		*pHigh = RssiHigh + 5;
+	}
+}
+
+void AddWaterfallLine(void) {
+	uint8_t BarLow;
+	uint8_t BarHigh;
+	uint8_t *pLine;
+
+	GetBarRange(&BarLow, &BarHigh);
+	WaterfallHead = (WaterfallHead + 1) % WATERFALL_LINES;
+	pLine = Buffer->Waterfall[WaterfallHead];
+	for (uint8_t i = 0; i < ColumnCount; i += 2) {
+		pLine[i >> 1] = GetAdjustedLevel(Buffer->RssiValue[i], BarLow, BarHigh, 15)
+			| (GetAdjustedLevel(Buffer->RssiValue[i + 1], BarLow, BarHigh, 15) << 4);
+	}
+}
+
+// ST7735S vertical scrolling runs along screen X with this MADCTL, so the
+// waterfall doesn't scroll. Each sweep overwrites the oldest line in place,
+// top to bottom, and a marker left of the window points at the newest one.
+static uint8_t GetWaterfallY(uint8_t Line) {
+	return WATERFALL_Y + WATERFALL_LINES - 1 - Line;
+}
+
+static uint16_t GetWaterfallColor(uint8_t Line, uint8_t x) {
+	const uint8_t Bin = x / BarWidth;
+
+	return WaterfallPalette[(Buffer->Waterfall[Line][Bin >> 1] >> ((Bin & 1) * 4)) & 0xF];
+}
+
+static void DrawWaterfallMarker(uint8_t Line, uint16_t Color) {
+	const uint8_t Y = GetWaterfallY(Line);
+
+	DISPLAY_Fill(14, 15, Y, Y, Color);
+}
+
+// Full repaint, only needed after the lines were cleared
+void DrawWaterfall(void) {
+	ST7735S_SetWindow(16, 143, WATERFALL_Y, WATERFALL_Y + WATERFALL_LINES - 1);
+	ST7735S_BeginPixels();
+	for (uint8_t x = 0; x < 128; x++) {
+		for (uint8_t y = 0; y < WATERFALL_LINES; y++) {
+			ST7735S_PushPixel(GetWaterfallColor(WATERFALL_LINES - 1 - y, x));
+		}
+	}
+	ST7735S_EndPixels();
+}
+
+// One 128 pixel line per sweep instead of the 128x22 window
+void DrawWaterfallLine(uint8_t Previous) {
+	const uint8_t Y = GetWaterfallY(WaterfallHead);
+
+	ST7735S_SetWindow(16, 143, Y, Y);
+	ST7735S_BeginPixels();
+	for (uint8_t x = 0; x < 128; x++) {
+		ST7735S_PushPixel(GetWaterfallColor(WaterfallHead, x));
+	}
+	ST7735S_EndPixels();
+
+	DrawWaterfallMarker(Previous, COLOR_BACKGROUND);
+	DrawWaterfallMarker(WaterfallHead, COLOR_FOREGROUND);
+}
+
+static uint16_t GetBarColor(uint16_t Power) {
+	if (Power == 0) {
+		return COLOR_RGB(0,  0,  0);
+	}
+	if (Power <= 20) {
+		COLOR_R = 0;
+		COLOR_G = (Power * 4) - 1;
+		COLOR_B = (21 - Power) * 4 - 1;
+	} else {
+		COLOR_R = (Power - 20) * 4 - 1;
+		COLOR_G = (41 - Power) * 4 - 1;
+		COLOR_B = 0;
+	}
+	if(COLOR_R > 63) {COLOR_R = 63;}
+	if(COLOR_G > 63) {COLOR_G = 63;}
+	if(COLOR_B > 63) {COLOR_B = 63;}
+
+	return COLOR_RGB(COLOR_R,  COLOR_G,  COLOR_B);
+}
+
+static void DrawBar(uint8_t i, uint16_t Power, uint16_t SquelchPower, uint16_t ActiveBarColor) {
+	const uint8_t BarX = 16 + (i * BarWidth);
+	const uint8_t ActiveColumn = CurrentFreqIndex / BinsPerColumn;
+
+	if (SpectrumColorMode > 0) {
+		COLOR_BAR = GetBarColor(Power);
+	}
+
+	if (Power < SquelchPower) {
+		if (SpectrumColorMode == 1) {
+			DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, COLOR_BAR);
+			DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BACKGROUND);
+			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BACKGROUND);
+		} else if (SpectrumColorMode == 2){
+			DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, (i == ActiveColumn) ? ActiveBarColor : COLOR_FOREGROUND);
+			DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BAR);
+			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BAR);
+		} else if (SpectrumColorMode == 3){
+			DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, COLOR_BAR);
+			DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BAR);
+			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BAR);
+		} else {
+			DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, (i == ActiveColumn) ? ActiveBarColor : COLOR_FOREGROUND);
+			DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BACKGROUND);
+			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BACKGROUND);
+		}
+	} else {
+		if (SpectrumColorMode == 1) {
+			DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, COLOR_BAR);
+			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, COLOR_BAR);
+			DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BACKGROUND);
+		} else if (SpectrumColorMode == 2){
+			DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, (i == ActiveColumn) ? ActiveBarColor : COLOR_FOREGROUND);
+			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, (i == ActiveColumn) ? ActiveBarColor : COLOR_FOREGROUND);
+			DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BAR);
+		} else if (SpectrumColorMode == 3){
+			DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, COLOR_BAR);
+			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, COLOR_BAR);
+			DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BAR);
+		} else {
+			DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, (i == ActiveColumn) ? ActiveBarColor : COLOR_FOREGROUND);
+			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, (i == ActiveColumn) ? ActiveBarColor : COLOR_FOREGROUND);
+			DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BACKGROUND);
+		}
+	}
+}
+
 void DrawSpectrum(uint16_t ActiveBarColor) {
+	const uint8_t ActiveColumn = CurrentFreqIndex / BinsPerColumn;
 	uint8_t BarLow;
 	uint8_t BarHigh;
 	uint16_t Power;
 	uint16_t SquelchPower;
-	uint8_t BarX;
+	uint8_t Trace = BAR_NOT_DRAWN;
 	
-	BarLow = RssiLow - 2;
-	if ((RssiHigh - RssiLow) < 40) {
-		BarHigh = RssiLow + 40;
-	} else {
-		BarHigh = RssiHigh + 5;
+	GetBarRange(&BarLow, &BarHigh);
+
+	SquelchPower = GetAdjustedLevel(SquelchLevel, BarLow, BarHigh, BarScale);
+
+	// Anything that moves every bar or the squelch line forces a full repaint.
+	if (SquelchPower != DrawnSquelchPower || SpectrumColorMode != DrawnColorMode || CurrentStepCount != DrawnStepCount || TraceMode != DrawnTraceMode) {
+		memset(Buffer->DrawnPower, BAR_NOT_DRAWN, sizeof(Buffer->DrawnPower));
+		memset(Buffer->DrawnTrace, BAR_NOT_DRAWN, sizeof(Buffer->DrawnTrace));
+	}
+	if (ActiveColumn != DrawnActiveIndex || ActiveBarColor != DrawnActiveColor) {
+		Buffer->DrawnPower[DrawnActiveIndex] = BAR_NOT_DRAWN;
+		Buffer->DrawnPower[ActiveColumn] = BAR_NOT_DRAWN;
 	}
 
 //Bars
-	for (uint8_t i = 0; i < CurrentStepCount; i++) {
-		BarX = 16 + (i * BarWidth);
-		Power = GetAdjustedLevel(RssiValue[i], BarLow, BarHigh, BarScale);
-		SquelchPower = GetAdjustedLevel(SquelchLevel, BarLow, BarHigh, BarScale);
-		
-		if (SpectrumColorMode > 0) {
-			if(Power == 0) {COLOR_BAR = COLOR_RGB(0,  0,  0);}
-			if(Power > 0 && Power <= 20) {
-				COLOR_R = 0;
-				COLOR_G = (Power * 4) - 1;
-				COLOR_B = (21 - Power) * 4 - 1;
-			}
-			if(Power > 20 && Power <= 40) {
-				COLOR_R = (Power - 20) * 4 - 1;
-				COLOR_G = (41 - Power) * 4 - 1;
-				COLOR_B = 0;
-			}
-			if(COLOR_R > 63) {COLOR_R = 63;}
-			if(COLOR_R < 0) {COLOR_R = 0;}
-			if(COLOR_G > 63) {COLOR_G = 63;}
-			if(COLOR_G < 0) {COLOR_G = 0;}
-			if(COLOR_B > 63) {COLOR_B = 63;}
-			if(COLOR_B < 0) {COLOR_B = 0;}
-			COLOR_BAR = COLOR_RGB(COLOR_R,  COLOR_G,  COLOR_B);
+	for (uint8_t i = 0; i < ColumnCount; i++) {
+		Power = GetAdjustedLevel(Buffer->RssiValue[i], BarLow, BarHigh, BarScale);
+		if (TraceMode != TRACE_LIVE) {
+			Trace = GetAdjustedLevel(Buffer->ColumnTrace[i] >> 4, BarLow, BarHigh, BarScale);
 		}
-		
-		if (Power < SquelchPower) {
-			if (SpectrumColorMode == 1) {
-				DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, COLOR_BAR);
-				DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BACKGROUND);
-				DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BACKGROUND);
-			} else if (SpectrumColorMode == 2){
-				DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-				DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BAR);
-				DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BAR);
-			} else if (SpectrumColorMode == 3){
-				DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, COLOR_BAR);
-				DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BAR);
-				DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BAR);
-			} else {
-				DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-				DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BACKGROUND);
-				DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BACKGROUND);
+		if (Power != Buffer->DrawnPower[i] || Trace != Buffer->DrawnTrace[i]) {
+			// The bar repaint also erases the previous trace marker
+			DrawBar(i, Power, SquelchPower, ActiveBarColor);
+			if (Trace != BAR_NOT_DRAWN && Trace != SquelchPower) {
+				DISPLAY_DrawRectangle1(16 + (i * BarWidth), BarY + Trace, 1, BarWidth, COLOR_TRACE);
 			}
-			
-		} else {
-			if (SpectrumColorMode == 1) {
-				DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, COLOR_BAR);
-				DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, COLOR_BAR);
-				DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BACKGROUND);
-			} else if (SpectrumColorMode == 2){
-				DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-				DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-				DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BAR);
-			} else if (SpectrumColorMode == 3){
-				DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, COLOR_BAR);
-				DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, COLOR_BAR);
-				DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BAR);
-			} else {
-				DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-				DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-				DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BACKGROUND);
-			}
-		} 
+			Buffer->DrawnPower[i] = Power;
+			Buffer->DrawnTrace[i] = Trace;
+		}
 	}
 	
-	//Squelch Line
-	Power = GetAdjustedLevel(SquelchLevel, BarLow, BarHigh, BarScale);
-	DISPLAY_DrawRectangle1(16, BarY + Power, 1, 128, COLOR_GREY);
+	//Squelch Line, the bars never paint over its row
+	if (SquelchPower != DrawnSquelchPower || CurrentStepCount != DrawnStepCount) {
+		DISPLAY_DrawRectangle1(16, BarY + SquelchPower, 1, 128, COLOR_GREY);
+	}
+
+	DrawnSquelchPower = SquelchPower;
+	DrawnColorMode = SpectrumColorMode;
+	DrawnStepCount = CurrentStepCount;
+	DrawnActiveIndex = ActiveColumn;
+	DrawnActiveColor = ActiveBarColor;
+	DrawnTraceMode = TraceMode;
 
 	gColorForeground = ActiveBarColor;
-	ConvertRssiToDbm(RssiValue[CurrentFreqIndex]);
+	ConvertRssiToDbm(Buffer->Rssi[CurrentFreqIndex]);
 	UI_DrawSmallString(52, 60, gShortString, 4);//dBM active frequency
 
 	gColorForeground = COLOR_GREY;
@@ -386,6 +1043,10 @@ void DrawSpectrum(uint16_t ActiveBarColor) {
 
 void StopSpectrum(void) {
 
+	// The last stream frame is sent straight from gFlashBuffer
+	while (UART_IsSending()) {
+	}
+
 	SCREEN_TurnOn();
 
 	if (gSettings.WorkMode) {
@@ -400,7 +1061,44 @@ void StopSpectrum(void) {
 	UI_DrawMain(false);
 }
 
+// Returns TRUE once per press, after the key has been stable for SIDE_KEY_DEBOUNCE ms.
+static uint8_t CheckSideKey(SideKey_t *pKey, uint8_t bRaw) {
+	if (bRaw != pKey->bRaw) {
+		pKey->bRaw = bRaw;
+		pKey->ChangeTime = gTimeSinceBoot;
+		return FALSE;
+	}
+	if (bRaw == pKey->bPressed || gTimeSinceBoot - pKey->ChangeTime < SIDE_KEY_DEBOUNCE) {
+		return FALSE;
+	}
+	pKey->bPressed = bRaw;
+
+	return bRaw;
+}
+
+// The TMR1 interrupt keeps counting side key presses while the spectrum runs,
+// drop them so Task_CheckSideKeys does not fire an action once back on the main screen.
+static void ResetSideKeys(void) {
+	KEY_Side1Counter = 0;
+	KEY_Side2Counter = 0;
+	if (!gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1) || !gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2)) {
+		// Still held, counting resumes after the release
+		KEY_SideKeyLongPressed = true;
+	}
+	gSlot = 6;
+}
+
 void CheckKeys(void) {
+	// Every keypad key is taken, side key 1 cycles the trace mode
+	if (CheckSideKey(&SideKey1, !gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1))) {
+		IncrementTraceMode();
+	}
+
+	// Side key 2 steps through the signal list
+	if (CheckSideKey(&SideKey2, !gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2))) {
+		SelectNextSignal();
+	}
+
 	Key = KEY_GetButton();
 	if (Key == LastKey && Key != KEY_NONE) {
 		if (bRXMode) {
@@ -457,6 +1155,7 @@ void CheckKeys(void) {
 				DecrementFreqStepIndex();
 				break;
 			case KEY_8:
+				ToggleWaterfall();
 				break;
 			case KEY_9:
 				ChangeSquelchLevel(FALSE);
@@ -496,10 +1195,7 @@ void Spectrum_StartAudio(void) {
 		uint16_t reg_73 = BK4819_ReadRegister(0x73);
 		BK4819_WriteRegister(0x73, reg_73 | 0x10U);
 		if (CurrentModulation > 1) { // if SSB
-			BK4819_WriteRegister(0x43, 0b0010000001011000); // Filter 6.25KHz
-			BK4819_WriteRegister(0x37, 0b0001011000001111);
-			BK4819_WriteRegister(0x3D, 0b0010101101000101);
-			BK4819_WriteRegister(0x48, 0b0000001110101000);
+			BK4819_SetupSSB();
 		}
 	} else {
 		// FM
@@ -516,9 +1212,11 @@ void RunRX(void) {
 	bRXMode = TRUE;
 	Spectrum_StartAudio();
 
-	while(RssiValue[CurrentFreqIndex] > SquelchLevel) {
-		RssiValue[CurrentFreqIndex] = BK4819_GetRSSI();
+	while(Buffer->Rssi[CurrentFreqIndex] > SquelchLevel) {
+		Buffer->Rssi[CurrentFreqIndex] = BK4819_GetRSSI();
+		Buffer->RssiValue[CurrentFreqIndex / BinsPerColumn] = Buffer->Rssi[CurrentFreqIndex];
 		CheckKeys();
+		UART_CheckSession();
 		if (bExit){
 			RADIO_EndAudio();
 			return;
@@ -534,6 +1232,10 @@ void RunRX(void) {
 
 void Spectrum_Loop(void) {
 	uint32_t FreqToCheck;
+	uint32_t SweepStart;
+	uint16_t Rssi;
+	uint8_t bSeedTrace = FALSE;
+	uint32_t RssiSum = 0;
 	CurrentFreqIndex = 0;
 	CurrentFreq = FreqMin;
 	bResetSquelch = TRUE;
@@ -584,29 +1286,64 @@ void Spectrum_Loop(void) {
 	while (1) {
 		FreqToCheck = FreqMin;
 		bRestartScan = TRUE;
+		if (bStreamRequest) {
+			ApplyStreamRequest();
+		}
+		if (bAdaptiveDwell && SettleTime[CurrentFreqStepIndex] == 0) {
+			CalibrateSettle();
+		}
+		SweepStart = gTimeSinceBoot;
 
-		for (uint8_t i = 0; i < CurrentStepCount; i++) {
+		for (uint16_t i = 0; i < CurrentStepCount; i++) {
+			uint8_t Column;
 
 			if (bRestartScan) {
 				bRestartScan = FALSE;
 				RssiLow = 330;
 				RssiHigh = 72;
 				i = 0;
+				FreqToCheck = FreqMin;
+				RssiSum = 0;
+				// A trace reset only takes effect on a full sweep
+				bSeedTrace = bTraceReset;
+				if (bTraceReset) {
+					TraceSweeps = 0;
+				}
+				bTraceReset = FALSE;
 			}
+			Column = i / BinsPerColumn;
 
 			BK4819_set_rf_frequency(FreqToCheck, TRUE);
 
-			DELAY_WaitMS(CurrentScanDelay);
+			if (bAdaptiveDwell) {
+				Rssi = ReadAdaptive(i);
+			} else {
+				DELAY_WaitMS(CurrentScanDelay);
+				Rssi = BK4819_GetRSSI();
+			}
+			Buffer->Rssi[i] = Rssi;
+			RssiSum += Rssi;
 
-			RssiValue[i] = BK4819_GetRSSI();
+			// Screen columns keep the strongest bin of their group
+			if ((i % BinsPerColumn) == 0 || Rssi > Buffer->RssiValue[Column]) {
+				Buffer->RssiValue[Column] = Rssi;
+			}
+
+			if (TraceMode != TRACE_LIVE) {
+				const uint16_t Trace = UpdateTrace(i, Rssi, bSeedTrace);
 
-			if (RssiValue[i] < RssiLow) {
-				RssiLow = RssiValue[i];
-			} else if (RssiValue[i] > RssiHigh) {
-				RssiHigh = RssiValue[i];
+				if ((i % BinsPerColumn) == 0 || Trace > Buffer->ColumnTrace[Column]) {
+					Buffer->ColumnTrace[Column] = Trace;
+				}
 			}
 
-			if (RssiValue[i] > RssiValue[CurrentFreqIndex] && !bHold) {
+			if (Rssi < RssiLow) {
+				RssiLow = Rssi;
+			} else if (Rssi > RssiHigh) {
+				RssiHigh = Rssi;
+			}
+
+			if (Rssi > Buffer->Rssi[CurrentFreqIndex] && !bHold) {
 				CurrentFreqIndex = i;
 				CurrentFreq = FreqToCheck;
 			}
@@ -614,17 +1351,36 @@ void Spectrum_Loop(void) {
 			FreqToCheck += CurrentFreqStep;
 
 			CheckKeys();
+			// The main loop is not running, programming commands are served here
+			UART_CheckSession();
 			if (bExit){
 				return;
 			}
 		}
 
-		if (bResetSquelch) {
+		bSeedTrace = FALSE;
+		if (TraceSweeps < TRACE_AVERAGE_SWEEPS) {
+			TraceSweeps++;
+		}
+		AdaptiveThreshold = (RssiSum / CurrentStepCount) + ADAPTIVE_MARGIN;
+		FindSignals(RssiSum / CurrentStepCount);
+		if (bStreaming) {
+			SendStreamFrame();
+		}
+
+		// The averaged floor is only used once enough sweeps went into it
+		if (bResetSquelch && (TraceMode != TRACE_AVERAGE || TraceSweeps >= TRACE_AVERAGE_SWEEPS)) {
 			bResetSquelch = FALSE;
-			SquelchLevel = RssiHigh + 5;
+			if (TraceMode == TRACE_AVERAGE) {
+				SquelchLevel = GetNoiseFloor() + TRACE_FLOOR_MARGIN;
+			} else {
+				SquelchLevel = RssiHigh + 5;
+			}
 		}
 
-		if (RssiValue[CurrentFreqIndex] > SquelchLevel) {
+		DrawSweepInfo(gTimeSinceBoot - SweepStart);
+
+		if (Buffer->Rssi[CurrentFreqIndex] > SquelchLevel) {
 			BK4819_set_rf_frequency(CurrentFreq, TRUE);
 			DELAY_WaitMS(CurrentScanDelay);
 			RunRX();
@@ -632,14 +1388,26 @@ void Spectrum_Loop(void) {
 
 		DrawCurrentFreq(COLOR_FOREGROUND);
 		DrawSpectrum(COLOR_RED);
+		if (bWaterfall) {
+			const uint8_t Previous = WaterfallHead;
+
+			AddWaterfallLine();
+			if (bWaterfallRedraw) {
+				bWaterfallRedraw = FALSE;
+				DrawWaterfall();
+			}
+			DrawWaterfallLine(Previous);
+		}
 	}
 }
 
 void APP_Spectrum(void) {
 	RADIO_EndAudio();  // Just in case audio is open when spectrum starts
+	AUDIO_Stop();  // Voice playback streams through gFlashBuffer
 	
 	bExit = FALSE;
 	bRXMode = FALSE;
+	bSpectrumOpen = TRUE;
 
 	FreqCenter = gVfoState[gSettings.CurrentVfo].RX.Frequency;
 	bNarrow = gVfoState[gSettings.CurrentVfo].bIsNarrow;
@@ -653,8 +1421,21 @@ void APP_Spectrum(void) {
 	BarScale = 40;
 	BarY = 15;
 	bHold = 0;
+	bWaterfall = 0;
+	TraceMode = TRACE_LIVE;
+	// Keys held from launching the spectrum must be released first
+	SideKey1.bRaw = TRUE;
+	SideKey1.bPressed = TRUE;
+	SideKey2.bRaw = TRUE;
+	SideKey2.bPressed = TRUE;
+	ResetSideKeys();
+	bStreaming = FALSE;
+	StreamSequence = 0;
+	bAdaptiveDwell = FALSE;
+	memset(SettleTime, 0, sizeof(SettleTime));
 	
 	SpectrumColorMode = 0;
+	DrawnStepCount = 0;
 
 	SetStepCount();
 	SetFreqMinMax(); 
@@ -668,5 +1449,7 @@ void APP_Spectrum(void) {
 	Spectrum_Loop();
 
 	StopSpectrum();
+	ResetSideKeys();
+	bSpectrumOpen = FALSE;
 }
 
@@ -17,7 +17,13 @@
 #ifndef RADIO_SPECTRUM_H
 #define RADIO_SPECTRUM_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 enum {
+  STEPS_1024,
+  STEPS_512,
+  STEPS_256,
   STEPS_128,
   STEPS_64,
   STEPS_32,
@@ -26,5 +32,7 @@ enum {
 };
 
 void APP_Spectrum(void);
+bool APP_SpectrumRequestStream(uint32_t Start, uint32_t Step, uint16_t Count);
+void APP_SpectrumCheckStream(void);
 
 #endif
\ No newline at end of file
@@ -15,17 +15,27 @@
  */
 
 #include "app/uart.h"
+#ifdef ENABLE_SPECTRUM
+	#include "app/spectrum.h"
+#endif
 #include "bsp/gpio.h"
 #include "driver/pins.h"
 #include "driver/serial-flash.h"
 #include "driver/uart.h"
 #include "radio/hardware.h"
 #include "radio/settings.h"
+#ifdef UART_DEBUG
+	#include "ui/font.h"
+#endif
 
 static uint8_t Buffer[256];
 static uint8_t BufferLength;
 static uint8_t Region;
 static bool bFlashing;
+static volatile bool bSessionPending;
+#ifdef UART_DEBUG
+static volatile bool bStatsPending;
+#endif
 static uint8_t g_Unused;
 
 uint16_t UART_Timer;
@@ -118,63 +128,141 @@ static void FlashCmd(uint8_t Command, uint8_t Hi, uint8_t Lo)
 	UART_SendByte(0x06);
 }
 
+static void RunCommand(void)
+{
+	const uint8_t Cmd = Buffer[0];
+
+	UART_IsRunning = true;
+	UART_Timer = 1000;
+	if (Cmd == 0x32) {
+		if (Buffer[3] != 0x16 && Buffer[3] == 0x10) {
+			UART_SendAck(6);
+		}
+	} else if (Cmd == 0x35) {
+		if (Buffer[3] == 16) {
+			g_Unused = 0;
+			UART_SendAck(0x06);
+		} else if (Buffer[3] == 0xEE) {
+			gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+			if (bFlashing) {
+				if (Region == 1) {
+					SETTINGS_BackupCalibration();
+				} else if (Region == 2) {
+					SETTINGS_BackupSettings();
+				}
+				gpio_bits_set(GPIOA, BOARD_GPIOA_LED_GREEN);
+				Region = 0;
+				HARDWARE_Reboot();
+			}
+			UART_IsRunning = false;
+			UART_Timer = 0;
+		}
+	} else {
+		FlashCmd(Cmd, Buffer[1], Buffer[2]);
+	}
+}
+
+// The first command of a session waits for UART_CheckSession, pending
+// settings are written from the main loop (or the spectrum loop) instead of
+// the interrupt.
+static void StartCommand(void)
+{
+	if (UART_IsRunning) {
+		RunCommand();
+	} else {
+		bSessionPending = true;
+	}
+}
+
+void UART_CheckSession(void)
+{
+#ifdef UART_DEBUG
+	// Debug counters, sent on request (3F) instead of from the code they measure
+	if (bStatsPending) {
+		while (UART_IsSending()) {
+		}
+		bStatsPending = false;
+		UART_printf("Font cache hits: %u misses: %u\r\n", (unsigned int)gFontCacheHits, (unsigned int)gFontCacheMisses);
+	}
+#endif
+	if (!bSessionPending) {
+		return;
+	}
+	SETTINGS_FlushGlobals();
+#ifdef ENABLE_SETTINGS_JOURNAL
+	SETTINGS_FlushJournal();
+#endif
+	// A spectrum frame going out would be cut by the reply
+	while (UART_IsSending()) {
+	}
+	// The host only sends the next command once this one is answered
+	bSessionPending = false;
+	RunCommand();
+}
+
 void HandlerUSART1(void)
 {
+	if (USART1->ctrl1_bit.tdbeien && USART1->sts & USART_TDBE_FLAG) {
+		UART_HandleTx();
+	}
+
 	if (USART1->ctrl1_bit.rdbfien && USART1->sts & USART_RDBF_FLAG) {
+		const uint8_t Data = USART1->dt;
 		uint8_t Cmd;
 
-		Buffer[BufferLength++] = USART1->dt;
+		// Buffer holds the command waiting for UART_CheckSession
+		if (bSessionPending) {
+			return;
+		}
+		Buffer[BufferLength++] = Data;
 
 		BufferLength %= 256;
 		Cmd = Buffer[0];
-		if (BufferLength == 1 && Cmd != 0x35 && !(Cmd >= 0x40 && Cmd <= 0x4C) && Cmd != 0x52) {
+#ifdef UART_DEBUG
+		if (BufferLength == 1 && Cmd == 0x3F) {
+			bStatsPending = true;
+			BufferLength = 0;
+			return;
+		}
+#endif
+		if (BufferLength == 1 && Cmd != 0x35 && !(Cmd >= 0x40 && Cmd <= 0x4C) && Cmd != 0x52
+#ifdef ENABLE_SPECTRUM
+			&& Cmd != 0x53
+#endif
+			) {
 			UART_IsRunning = false;
 			UART_Timer = 0;
-			UART_SendByte(0xFF);
+			UART_SendAck(0xFF);
 			BufferLength = 0;
 		} else {
 			if ((Cmd == 0x35 && BufferLength == 5) || (Cmd == 0x52 && BufferLength == 4) || (Cmd >= 0x40 && Cmd <= 0x4C && BufferLength == 132)) {
 				if (CalcSum(Buffer, BufferLength - 1) == Buffer[BufferLength - 1]) {
 					gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_RED);
-					UART_IsRunning = true;
-					UART_Timer = 1000;
-					if (Cmd == 0x35) {
-						if (Buffer[3] == 16) {
-							g_Unused = 0;
-							UART_SendByte(0x06);
-						} else if (Buffer[3] == 0xEE) {
-							gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
-							if (bFlashing) {
-								if (Region == 1) {
-									SETTINGS_BackupCalibration();
-								} else if (Region == 2) {
-									SETTINGS_BackupSettings();
-								}
-								gpio_bits_set(GPIOA, BOARD_GPIOA_LED_GREEN);
-								Region = 0;
-								HARDWARE_Reboot();
-							}
-							UART_IsRunning = false;
-							UART_Timer = 0;
-						}
-					} else {
-						FlashCmd(Cmd, Buffer[1], Buffer[2]);
-					}
+					StartCommand();
 				} else {
 					gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
-					UART_SendByte(0xFF);
+					UART_SendAck(0xFF);
+				}
+				BufferLength = 0;
+#ifdef ENABLE_SPECTRUM
+			} else if (Cmd == 0x53 && BufferLength == 12) {
+				// Start, step (10 Hz units) and count, little endian. A count of 0 stops the stream.
+				if (CalcSum(Buffer, 11) == Buffer[11] && APP_SpectrumRequestStream(
+						Buffer[1] | (Buffer[2] << 8) | (Buffer[3] << 16) | ((uint32_t)Buffer[4] << 24),
+						Buffer[5] | (Buffer[6] << 8) | (Buffer[7] << 16) | ((uint32_t)Buffer[8] << 24),
+						Buffer[9] | (Buffer[10] << 8))) {
+					UART_SendAck(0x06);
+				} else {
+					UART_SendAck(0xFF);
 				}
 				BufferLength = 0;
+#endif
 			} else if (Cmd == 0x32 && BufferLength == 5) {
 				if (CalcSum(Buffer, 4) + 1 == Buffer[4]) {
-					UART_IsRunning = true;
-					UART_Timer = 1000;
-					if (Buffer[3] != 0x16 && Buffer[3] == 0x10) {
-						UART_SendByte(6);
-					}
+					StartCommand();
 				} else {
 					gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
-					UART_SendByte(0xFF);
+					UART_SendAck(0xFF);
 					UART_IsRunning = false;
 					UART_Timer = 0;
 				}
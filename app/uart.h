@@ -23,5 +23,7 @@
 extern uint16_t UART_Timer;
 extern bool UART_IsRunning;
 
+void UART_CheckSession(void);
+
 #endif
 
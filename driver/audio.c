@@ -191,3 +191,8 @@ void AUDIO_PlayDigit(uint8_t Digit)
 	AudioEndPosition = 0x4000;
 }
 
+void AUDIO_Stop(void)
+{
+	gAudioPlaying = false;
+	TMR6->ctrl1_bit.tmren = FALSE;
+}
@@ -30,6 +30,7 @@ void AUDIO_PlayMenuSample(uint8_t ID);
 void AUDIO_PlaySampleOptional(uint8_t Index);
 void AUDIO_PlayChannelNumber(void);
 void AUDIO_PlayDigit(uint8_t Digit);
+void AUDIO_Stop(void);
 
 #endif
 
@@ -18,11 +18,14 @@
 #include "app/radio.h"
 #include "bsp/gpio.h"
 #include "driver/bk4819.h"
+#include "driver/crm.h"
 #include "driver/delay.h"
 #include "driver/pins.h"
 #include "driver/speaker.h"
+#include "driver/uart.h"
 #include "helper/helper.h"
 #include "misc.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 
 enum {
@@ -35,12 +38,35 @@ enum {
 	GPIO_FILTER_UNKWOWN = 1U << 7,
 };
 
+#ifdef BK4819_BUS_KHZ
+// Half a bus clock in core cycles, paced with the DWT cycle counter. Starts
+// slow enough for any core clock and is set from BK4819_BUS_KHZ at init.
+static uint32_t HalfBitCycles = 48;
+
+static void HalfBit(void)
+{
+	const uint32_t Start = DWT->CYCCNT;
+
+	while (DWT->CYCCNT - Start < HalfBitCycles) {
+	}
+}
+
+#define BUS_SET(Pins)	GPIOB->scr = (Pins)
+#define BUS_RESET(Pins)	GPIOB->clr = (Pins)
+#define BUS_SDA()		(GPIOB->idt & BOARD_GPIOB_BK4819_SDA)
+#else
 static void Delay(volatile uint8_t Counter)
 {
 	while (Counter-- > 0) {
 	}
 }
 
+#define HalfBit()		Delay(10)
+#define BUS_SET(Pins)	gpio_bits_set(GPIOB, (Pins))
+#define BUS_RESET(Pins)	gpio_bits_reset(GPIOB, (Pins))
+#define BUS_SDA()		gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_BK4819_SDA)
+#endif
+
 static void SDA_SetOutput(void)
 {
 	gpio_init_type init;
@@ -69,16 +95,16 @@ static void I2C_Send(uint8_t Data)
 	uint8_t i;
 
 	for (i = 0; i < 8; i++) {
-		gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
+		BUS_RESET(BOARD_GPIOB_BK4819_SCL);
 		if (Data & 0x80U) {
-			gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SDA);
+			BUS_SET(BOARD_GPIOB_BK4819_SDA);
 		} else {
-			gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SDA);
+			BUS_RESET(BOARD_GPIOB_BK4819_SDA);
 		}
-		Delay(10);
-		gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SCL);
+		HalfBit();
+		BUS_SET(BOARD_GPIOB_BK4819_SCL);
 		Data <<= 1;
-		Delay(10);
+		HalfBit();
 	}
 }
 
@@ -89,16 +115,16 @@ static uint16_t I2C_RecvU16(void)
 
 	SDA_SetInput();
 
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
+	BUS_RESET(BOARD_GPIOB_BK4819_SCL);
 	for (i = 0; i < 16; i++) {
 		Data <<= 1;
-		gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SCL);
-		if (gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_BK4819_SDA)) {
+		BUS_SET(BOARD_GPIOB_BK4819_SCL);
+		if (BUS_SDA()) {
 			Data |= 1;
 		}
-		Delay(10);
-		gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
-		Delay(10);
+		HalfBit();
+		BUS_RESET(BOARD_GPIOB_BK4819_SCL);
+		HalfBit();
 	}
 
 	return Data;
@@ -140,71 +166,292 @@ void OpenAudio(bool bIsNarrow, uint8_t gModulationType)
 	}
 }
 
-// Public
+#ifdef UART_DEBUG
+uint32_t gBK4819_BusTransactions;
+uint32_t gBK4819_SavedTransactions;
+uint32_t gBK4819_BusCycles;
+static uint32_t BusStartCycle;
+#endif
 
-uint16_t BK4819_ReadRegister(uint8_t Reg)
+static uint16_t BusRead(uint8_t Reg)
 {
 	uint16_t Data;
+#ifdef UART_DEBUG
+	const uint32_t Start = DWT->CYCCNT;
+#endif
 
 	TMR1->ctrl1_bit.tmren = FALSE;
 
 	SDA_SetOutput();
 
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_CS);
+	BUS_RESET(BOARD_GPIOB_BK4819_SCL);
+	BUS_RESET(BOARD_GPIOB_BK4819_CS);
 
 	I2C_Send(0x80U | Reg);
-	Delay(10);
+	HalfBit();
 	Data = I2C_RecvU16();
 
-	gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_CS);
+	BUS_SET(BOARD_GPIOB_BK4819_CS);
 
 	TMR1->ctrl1_bit.tmren = TRUE;
 
+#ifdef UART_DEBUG
+	gBK4819_BusTransactions++;
+	gBK4819_BusCycles += DWT->CYCCNT - Start;
+#endif
+
 	return Data;
 }
 
-void BK4819_WriteRegister(uint8_t Reg, uint16_t Data)
+// A write sequence keeps TMR1 stopped and SDA as output between registers
+static void BusStart(void)
 {
+#ifdef UART_DEBUG
+	BusStartCycle = DWT->CYCCNT;
+#endif
 	TMR1->ctrl1_bit.tmren = FALSE;
 
 	SDA_SetOutput();
+}
 
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_CS);
+static void BusStop(void)
+{
+	TMR1->ctrl1_bit.tmren = TRUE;
+#ifdef UART_DEBUG
+	gBK4819_BusCycles += DWT->CYCCNT - BusStartCycle;
+#endif
+}
+
+static void BusSend(uint8_t Reg, uint16_t Data)
+{
+	BUS_RESET(BOARD_GPIOB_BK4819_SCL);
+	BUS_RESET(BOARD_GPIOB_BK4819_CS);
 
 	I2C_Send(Reg);
 	I2C_Send((Data >> 8) & 0xFFU);
 	I2C_Send((Data >> 0) & 0xFFU);
 
-	gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_CS);
+	BUS_SET(BOARD_GPIOB_BK4819_CS);
+	// CS has to stay high for a while before the next register of a batch
+	HalfBit();
 
-	TMR1->ctrl1_bit.tmren = TRUE;
+#ifdef UART_DEBUG
+	gBK4819_BusTransactions++;
+#endif
+}
+
+#ifdef ENABLE_BK4819_SHADOW
+// Last value written to each register. Only registers we have written are
+// served from here, so anything the chip changes on its own must be listed
+// in Uncached: status/result registers, the soft reset, interrupt clear,
+// FSK FIFO/control (writes are triggers) and 0x7E (live AGC index).
+static uint16_t Shadow[0x80];
+static uint32_t ShadowValid[4];
+
+static const uint32_t Uncached[4] = {
+	// 0x00-0x02, 0x0B-0x0E
+	0x00007807U,
+	0x00000000U,
+	// 0x59, 0x5F
+	0x82000000U,
+	// 0x63-0x65, 0x67-0x6A, 0x7E
+	0x400007B8U,
+};
+
+static bool IsShadowed(uint8_t Reg)
+{
+	return (ShadowValid[Reg >> 5] >> (Reg & 31U)) & 1U;
+}
+#endif
+
+#ifdef BK4819_BUS_KHZ
+// Writes the complement and then each pattern back to back to the PLL low
+// word (reprogrammed by every tune) and reads the pattern back straight from
+// the bus. No complement is in the list, so the shadow never drops a write.
+static bool BusSelfTest(void)
+{
+	static const uint16_t Patterns[] = { 0xA55A, 0xFFFF, 0x3CC3, 0x0F0F };
+	BK4819_Register_t Batch[2];
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_SIZE(Patterns); i++) {
+		Batch[0].Reg = 0x38;
+		Batch[0].Value = ~Patterns[i];
+		Batch[1].Reg = 0x38;
+		Batch[1].Value = Patterns[i];
+		BK4819_WriteRegisters(Batch, ARRAY_SIZE(Batch));
+		if (BusRead(0x38) != Patterns[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void BusInitTiming(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	HalfBitCycles = gSystemCoreClock / (BK4819_BUS_KHZ * 2000U);
+	if (HalfBitCycles == 0) {
+		HalfBitCycles = 1;
+	}
+
+	// Halve the rate until read-back is clean, up to roughly 10 kHz at 48 MHz
+	while (!BusSelfTest() && HalfBitCycles < 2048) {
+		HalfBitCycles <<= 1;
+	}
+
+#ifdef UART_DEBUG
+	UART_printf("BK4819 bus: %u kHz\r\n", (unsigned int)(gSystemCoreClock / (HalfBitCycles * 2000U)));
+#endif
+}
+#endif
+
+// Returns true when the register already holds Data and the write can be dropped
+static bool SkipWrite(uint8_t Reg, uint16_t Data)
+{
+#ifdef ENABLE_BK4819_SHADOW
+	const uint32_t Mask = 1U << (Reg & 31U);
+
+	Reg &= 0x7FU;
+	if (Reg == 0x00) {
+		// Soft reset puts every register back to its default
+		ShadowValid[0] = 0;
+		ShadowValid[1] = 0;
+		ShadowValid[2] = 0;
+		ShadowValid[3] = 0;
+	} else if (!(Uncached[Reg >> 5] & Mask)) {
+		if (IsShadowed(Reg) && Shadow[Reg] == Data) {
+#ifdef UART_DEBUG
+			gBK4819_SavedTransactions++;
+#endif
+			return true;
+		}
+		Shadow[Reg] = Data;
+		ShadowValid[Reg >> 5] |= Mask;
+	}
+#endif
+
+	return false;
+}
+
+// Public
+
+uint16_t BK4819_ReadRegister(uint8_t Reg)
+{
+#ifdef ENABLE_BK4819_SHADOW
+	Reg &= 0x7FU;
+	if (IsShadowed(Reg)) {
+#ifdef UART_DEBUG
+		gBK4819_SavedTransactions++;
+#endif
+		return Shadow[Reg];
+	}
+#endif
+
+	return BusRead(Reg);
+}
+
+void BK4819_WriteRegister(uint8_t Reg, uint16_t Data)
+{
+	if (SkipWrite(Reg, Data)) {
+		return;
+	}
+
+	BusStart();
+	BusSend(Reg, Data);
+	BusStop();
+}
+
+void BK4819_WriteRegisters(const BK4819_Register_t *pRegisters, uint8_t Count)
+{
+	bool bStarted = false;
+	uint8_t i;
+
+	for (i = 0; i < Count; i++) {
+		if (SkipWrite(pRegisters[i].Reg, pRegisters[i].Value)) {
+			continue;
+		}
+		if (!bStarted) {
+			BusStart();
+			bStarted = true;
+		}
+		BusSend(pRegisters[i].Reg, pRegisters[i].Value);
+	}
+
+	if (bStarted) {
+		BusStop();
+	}
 }
 
+// REG_0C snapshots with the FSK/DTMF interrupt pending. Squelch and tone bits
+// are read from gBK4819_Status, only the interrupt has to be acted on once.
+// There is no BK4819 interrupt line on this board, so the producer is
+// BK4819_PollEvents() in the main loop; the ring is single-producer/
+// single-consumer so an EXTI handler could take over.
+#define EVENT_RING_SIZE 2U
+
+static uint16_t EventRing[EVENT_RING_SIZE];
+static volatile uint8_t EventHead;
+static volatile uint8_t EventTail;
+static bool bIrqQueued;
+static bool bStatusStale;
+static uint32_t StatusTime;
+
+uint16_t gBK4819_Status;
+
+// Squelch open levels last programmed, for the scanner's early rejection
+uint8_t gSquelchOpenRssi;
+uint8_t gSquelchOpenNoise;
+uint8_t gSquelchOpenGlitch;
+
 uint16_t BK4819_GetRSSI(void)
 {
 	return BK4819_ReadRegister(0x67) & 0x01FF;
 }
 
+uint8_t BK4819_GetNoise(void)
+{
+	return BK4819_ReadRegister(0x65) & 0x007F;
+}
+
+uint8_t BK4819_GetGlitch(void)
+{
+	return BK4819_ReadRegister(0x63) & 0x00FF;
+}
+
 void BK4819_Init(void)
 {
-	BK4819_WriteRegister(0x00, 0x8000);
-	BK4819_WriteRegister(0x00, 0x0000);
-	BK4819_WriteRegister(0x37, 0x1D0F);
-	// DisableAGC(0);
-	BK4819_WriteRegister(0x33, 0x1F00);
-	BK4819_WriteRegister(0x35, 0x0000);
-	BK4819_WriteRegister(0x1E, 0x4C58);
-	BK4819_WriteRegister(0x1F, 0xA656);
-	BK4819_WriteRegister(0x3E, gCalibration.BandSelectionThreshold);
-	BK4819_WriteRegister(0x3F, 0x0000);
-	BK4819_WriteRegister(0x2A, 0x4F18);
-	BK4819_WriteRegister(0x53, 0xE678);
-	BK4819_WriteRegister(0x2C, 0x5705);
-	BK4819_WriteRegister(0x4B, 0x7102);
-	//BK4819_WriteRegister(0x77, 0x88EF);
-	BK4819_WriteRegister(0x26, 0x13A0);
+	const BK4819_Register_t Init[] = {
+		{ 0x00, 0x8000 },
+		{ 0x00, 0x0000 },
+		{ 0x37, 0x1D0F },
+		// DisableAGC(0);
+		{ 0x33, 0x1F00 },
+		{ 0x35, 0x0000 },
+		{ 0x1E, 0x4C58 },
+		{ 0x1F, 0xA656 },
+		{ 0x3E, gCalibration.BandSelectionThreshold },
+		{ 0x3F, 0x0000 },
+		{ 0x2A, 0x4F18 },
+		{ 0x53, 0xE678 },
+		{ 0x2C, 0x5705 },
+		{ 0x4B, 0x7102 },
+		//{ 0x77, 0x88EF },
+		{ 0x26, 0x13A0 },
+	};
+
+#ifdef UART_DEBUG
+	// Bus time is counted in core cycles
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+#ifdef BK4819_BUS_KHZ
+	BusInitTiming();
+#endif
+	BK4819_WriteRegisters(Init, ARRAY_SIZE(Init));
 	BK4819_SetAFResponseCoefficients(false, true,  gCalibration.RX_3000Hz_Coefficient);
 	BK4819_SetAFResponseCoefficients(false, false, gCalibration.RX_300Hz_Coefficient);
 	BK4819_SetAFResponseCoefficients(true,  true,  gCalibration.TX_3000Hz_Coefficient);
@@ -266,6 +513,17 @@ void BK4819_EnableRX(void)
 	BK4819_WriteRegister(0x30, 0xBFF1);
 }
 
+// Relock the PLL on a new frequency without leaving RX
+void BK4819_RetuneRX(void)
+{
+	static const BK4819_Register_t Retune[] = {
+		{ 0x30, 0xBFF1 & ~BK4819_REG_30_ENABLE_VCO_CALIB },
+		{ 0x30, 0xBFF1 },
+	};
+
+	BK4819_WriteRegisters(Retune, ARRAY_SIZE(Retune));
+}
+
 void BK4819_SetAF(BK4819_AF_Type_t Type)
 {
 	BK4819_WriteRegister(0x47, 0x6040 | (Type << 8));
@@ -273,15 +531,19 @@ void BK4819_SetAF(BK4819_AF_Type_t Type)
 
 void BK4819_SetFrequency(uint32_t Frequency)
 {
+	BK4819_Register_t Pll[2];
+
 	FREQUENCY_SelectBand(Frequency);
 	Frequency = (Frequency - 32768U) + gFrequencyBandInfo.FrequencyOffset;
-	BK4819_WriteRegister(0x38, (Frequency >>  0) & 0xFFFFU);
-	BK4819_WriteRegister(0x39, (Frequency >> 16) & 0xFFFFU);
+	Pll[0] = (BK4819_Register_t){ 0x38, (Frequency >>  0) & 0xFFFFU };
+	Pll[1] = (BK4819_Register_t){ 0x39, (Frequency >> 16) & 0xFFFFU };
+
+	BK4819_WriteRegisters(Pll, ARRAY_SIZE(Pll));
+	bStatusStale = true;
 }
 
-void BK4819_SetSquelchGlitch(bool bIsNarrow)
+static uint8_t SquelchGlitch(BK4819_Register_t *pRegs, bool bIsNarrow)
 {
-
 #ifdef ENABLE_ALT_SQUELCH
 	uint16_t Value;
 
@@ -304,7 +566,8 @@ void BK4819_SetSquelchGlitch(bool bIsNarrow)
 		Value = SquelchGlitchOpenLevel[gSettings.Squelch];
 	}
 
-	BK4819_WriteRegister(0x4E, (BK4819_ReadRegister(0x4E) & 0xFF00) | Value);
+	pRegs[0] = (BK4819_Register_t){ 0x4E, (BK4819_ReadRegister(0x4E) & 0xFF00) | Value };
+	gSquelchOpenGlitch = Value;
 
 	if (gSettings.Squelch == 0){
 		Value = 255;
@@ -312,7 +575,7 @@ void BK4819_SetSquelchGlitch(bool bIsNarrow)
 		Value = (Value * 10) / 9;
 	}
 
-	BK4819_WriteRegister(0x4D, 0xA0 << 8 | Value);
+	pRegs[1] = (BK4819_Register_t){ 0x4D, 0xA0 << 8 | Value };
 #else
 
 	static const uint8_t gSquelchGlitchLevel[11] = {
@@ -330,17 +593,20 @@ void BK4819_SetSquelchGlitch(bool bIsNarrow)
 	};
 	
 	if (bIsNarrow) {
-		BK4819_WriteRegister(0x4D, gSquelchGlitchLevel[gSettings.Squelch] + 0x9FFF);
-		BK4819_WriteRegister(0x4E, gSquelchGlitchLevel[gSettings.Squelch] + 0x4DFE);
+		pRegs[0] = (BK4819_Register_t){ 0x4D, gSquelchGlitchLevel[gSettings.Squelch] + 0x9FFF };
+		pRegs[1] = (BK4819_Register_t){ 0x4E, gSquelchGlitchLevel[gSettings.Squelch] + 0x4DFE };
+		gSquelchOpenGlitch = gSquelchGlitchLevel[gSettings.Squelch] - 2;
 	} else {
-		BK4819_WriteRegister(0x4D, gSquelchGlitchLevel[gSettings.Squelch] + 0xA000);
-		BK4819_WriteRegister(0x4E, gSquelchGlitchLevel[gSettings.Squelch] + 0x4DFF);
+		pRegs[0] = (BK4819_Register_t){ 0x4D, gSquelchGlitchLevel[gSettings.Squelch] + 0xA000 };
+		pRegs[1] = (BK4819_Register_t){ 0x4E, gSquelchGlitchLevel[gSettings.Squelch] + 0x4DFF };
+		gSquelchOpenGlitch = gSquelchGlitchLevel[gSettings.Squelch] - 1;
 	}
 #endif
 
+	return 2;
 }
 
-void BK4819_SetSquelchNoise(bool bIsNarrow)
+static uint8_t SquelchNoise(BK4819_Register_t *pRegs, bool bIsNarrow)
 {
 #ifdef ENABLE_ALT_SQUELCH
 
@@ -370,7 +636,8 @@ void BK4819_SetSquelchNoise(bool bIsNarrow)
 		 }
 	}
 
-	BK4819_WriteRegister(0x4F, Value);
+	pRegs[0] = (BK4819_Register_t){ 0x4F, Value };
+	gSquelchOpenNoise = Value & 0x7F;
 
 #else
 
@@ -398,13 +665,15 @@ void BK4819_SetSquelchNoise(bool bIsNarrow)
 		Value = ((gSquelchNoiseWide   + 12 + Level) << 8) | (gSquelchNoiseWide   - 6 + Level);
 	}
 
-	BK4819_WriteRegister(0x4F, Value);
+	pRegs[0] = (BK4819_Register_t){ 0x4F, Value };
+	gSquelchOpenNoise = Value & 0x7F;
 
 #endif
 
+	return 1;
 }
 
-void BK4819_SetSquelchRSSI(bool bIsNarrow)
+static uint8_t SquelchRSSI(BK4819_Register_t *pRegs, bool bIsNarrow)
 {
 #ifdef ENABLE_ALT_SQUELCH
 
@@ -430,7 +699,8 @@ void BK4819_SetSquelchRSSI(bool bIsNarrow)
 		Value = (Value << 8) | (Value * 9) / 10;
 	}
 
-	BK4819_WriteRegister(0x78, Value);
+	pRegs[0] = (BK4819_Register_t){ 0x78, Value };
+	gSquelchOpenRssi = Value >> 8;
 #else
 
 	static const uint8_t gSquelchRssiLevel[11] = {
@@ -457,10 +727,23 @@ void BK4819_SetSquelchRSSI(bool bIsNarrow)
 		Value = ((gSquelchRSSIWide   - 8 + Level) << 8) | (gSquelchRSSIWide   - 14 + Level);
 	}
 
-	BK4819_WriteRegister(0x78, Value);
+	pRegs[0] = (BK4819_Register_t){ 0x78, Value };
+	gSquelchOpenRssi = Value >> 8;
 
 #endif
 
+	return 1;
+}
+
+void BK4819_SetSquelch(bool bIsNarrow)
+{
+	BK4819_Register_t Regs[4];
+	uint8_t Count;
+
+	Count = SquelchGlitch(Regs, bIsNarrow);
+	Count += SquelchNoise(Regs + Count, bIsNarrow);
+	Count += SquelchRSSI(Regs + Count, bIsNarrow);
+	BK4819_WriteRegisters(Regs, Count);
 }
 
 void BK4819_SetFilterBandwidth(bool bIsNarrow)
@@ -563,11 +846,15 @@ void BK4819_RestoreGainSettings()
 			}
 	
 	Default values*/
-	BK4819_WriteRegister(0x10, 0x0038);  
-	BK4819_WriteRegister(0x11, 0x027B);
-	BK4819_WriteRegister(0x12, 0x037B); 
-	BK4819_WriteRegister(0x13, 0x03F5);
-	BK4819_WriteRegister(0x14, 0x0019);
+	static const BK4819_Register_t Gain[] = {
+		{ 0x10, 0x0038 },
+		{ 0x11, 0x027B },
+		{ 0x12, 0x037B },
+		{ 0x13, 0x03F5 },
+		{ 0x14, 0x0019 },
+	};
+
+	BK4819_WriteRegisters(Gain, ARRAY_SIZE(Gain));
 }	
 
 void BK4819_ToggleAGCMode()
@@ -614,6 +901,18 @@ void BK4819_ResetFSK(void)
 	//BK4819_WriteRegister(0x30, 0x0000);
 }
 
+void BK4819_SetupSSB(void)
+{
+	static const BK4819_Register_t Ssb[] = {
+		{ 0x43, 0b0010000001011000 }, // Filter 6.25KHz
+		{ 0x37, 0b0001011000001111 },
+		{ 0x3D, 0b0010101101000101 },
+		{ 0x48, 0b0000001110101000 },
+	};
+
+	BK4819_WriteRegisters(Ssb, ARRAY_SIZE(Ssb));
+}
+
 void BK4819_StartAudio(void)
 {
 	gpio_bits_set(GPIOA, BOARD_GPIOA_LED_GREEN);
@@ -633,10 +932,7 @@ void BK4819_StartAudio(void)
 		BK4819_WriteRegister(0x73, reg_73 | 0x10U);
 		// BK4819_WriteRegister(0x43, 0b0100000001011000); // Filter 6.25KHz
 		if (gMainVfo->gModulationType > 1) { // if SSB
-			BK4819_WriteRegister(0x43, 0b0010000001011000); // Filter 6.25KHz
-			BK4819_WriteRegister(0x37, 0b0001011000001111);
-    		BK4819_WriteRegister(0x3D, 0b0010101101000101);
-    		BK4819_WriteRegister(0x48, 0b0000001110101000);
+			BK4819_SetupSSB();
 		}
 	} else {
 		// FM
@@ -684,10 +980,57 @@ void BK4819_SetAfGain(uint16_t Gain)
 	}
 }
 
+static void PushEvent(uint16_t Status)
+{
+	const uint8_t Head = EventHead;
+
+	if ((uint8_t)(Head - EventTail) >= EVENT_RING_SIZE) {
+		return;
+	}
+	EventRing[Head % EVENT_RING_SIZE] = Status;
+	EventHead = Head + 1;
+	bIrqQueued = true;
+}
+
+void BK4819_PollEvents(void)
+{
+	uint16_t Status;
+
+	// One bus read per scheduler tick, shared by every task that asks
+	if (StatusTime == gTimeSinceBoot && !bStatusStale) {
+		return;
+	}
+	StatusTime = gTimeSinceBoot;
+	bStatusStale = false;
+
+	Status = BK4819_ReadRegister(0x0C);
+	// The IRQ line stays up until 0x02 is cleared, so keep one IRQ event
+	// outstanding rather than one per poll
+	if ((Status & BK4819_EVENT_IRQ) && !bIrqQueued) {
+		PushEvent(Status);
+	}
+	gBK4819_Status = Status;
+}
+
+bool BK4819_GetEvent(uint16_t *pStatus)
+{
+	const uint8_t Tail = EventTail;
+
+	if (Tail == EventHead) {
+		return false;
+	}
+	*pStatus = EventRing[Tail % EVENT_RING_SIZE];
+	EventTail = Tail + 1;
+	bIrqQueued = false;
+
+	return true;
+}
+
 bool BK4819_CheckSquelchLink(void)
 {
 	if (gSettings.Squelch && !gMonitorMode) {
-		return ((BK4819_ReadRegister(0x0C) >> 1) & 1);
+		BK4819_PollEvents();
+		return (gBK4819_Status & BK4819_EVENT_SQUELCH) != 0;
 	}
 
 	return true;
@@ -788,8 +1131,8 @@ void BK4819_EnableTX(bool bUseMic)
 
 void BK4819_StartFrequencyScan(void)
 {
+	// Needs ~200 ms before REG_0D holds a new count, the caller waits
 	BK4819_WriteRegister(0x32, 0x0B01);
-	DELAY_WaitMS(200);
 }
 
 void BK4819_StopFrequencyScan(void)
@@ -799,9 +1142,8 @@ void BK4819_StopFrequencyScan(void)
 
 void BK4819_DisableAutoCssBW(void)
 {
+	// Needs ~200 ms before BK4819_EnableRX(), the caller waits
 	BK4819_WriteRegister(0x51, 0x0300);
-	DELAY_WaitMS(200);
-	BK4819_EnableRX();
 }
 
 #ifdef ENABLE_SPECTRUM
@@ -37,19 +37,50 @@ enum BK4819_AF_Type_t {
 
 typedef enum BK4819_AF_Type_t BK4819_AF_Type_t;
 
+// REG_0C status bits carried by BK4819 events
+enum {
+	BK4819_EVENT_IRQ     = 0x0001U, // FSK/DTMF interrupt pending
+	BK4819_EVENT_SQUELCH = 0x0002U,
+	BK4819_EVENT_CTC1    = 0x0400U,
+	BK4819_EVENT_CTC2    = 0x0800U, // 55 Hz tail tone
+	BK4819_EVENT_DCS_N   = 0x4000U,
+	BK4819_EVENT_DCS_I   = 0x8000U,
+};
+
+typedef struct {
+	uint8_t Reg;
+	uint16_t Value;
+} BK4819_Register_t;
+
+extern uint8_t gSquelchOpenRssi;
+extern uint8_t gSquelchOpenNoise;
+extern uint8_t gSquelchOpenGlitch;
+// Last REG_0C read by BK4819_PollEvents()
+extern uint16_t gBK4819_Status;
+
+#ifdef UART_DEBUG
+// Register transactions clocked on the bus and ones the shadow made unnecessary.
+extern uint32_t gBK4819_BusTransactions;
+extern uint32_t gBK4819_SavedTransactions;
+// Core cycles spent on the bus, TMR1 included as it is stopped meanwhile
+extern uint32_t gBK4819_BusCycles;
+#endif
+
 void OpenAudio(bool bIsNarrow, uint8_t gModulationType);
 uint16_t BK4819_ReadRegister(uint8_t Reg);
 uint16_t BK4819_GetRSSI();
+uint8_t BK4819_GetNoise(void);
+uint8_t BK4819_GetGlitch(void);
 void BK4819_WriteRegister(uint8_t Reg, uint16_t Data);
+void BK4819_WriteRegisters(const BK4819_Register_t *pRegisters, uint8_t Count);
 
 void BK4819_Init(void);
 void BK4819_SetAFResponseCoefficients(bool bTx, bool bLowPass, uint8_t Index);
 void BK4819_EnableRX(void);
+void BK4819_RetuneRX(void);
 void BK4819_SetAF(BK4819_AF_Type_t Type);
 void BK4819_SetFrequency(uint32_t Frequency);
-void BK4819_SetSquelchGlitch(bool bIsNarrow);
-void BK4819_SetSquelchNoise(bool bIsNarrow);
-void BK4819_SetSquelchRSSI(bool bIsNarrow);
+void BK4819_SetSquelch(bool bIsNarrow);
 void BK4819_ToggleAGCMode(void);
 void BK4819_RestoreGainSettings();
 void BK4819_SetFilterBandwidth(bool bIsNarrow);
@@ -60,9 +91,12 @@ void BK4819_EnableVox(bool bEnable);
 void BK4819_SetToneFrequency(bool Tone2, uint16_t Tone);
 void BK4819_EnableFFSK1200(bool bEnable);
 void BK4819_ResetFSK(void);
+void BK4819_SetupSSB(void);
 void BK4819_StartAudio(void);
 void BK4819_SetAfGain(uint16_t Gain);
 void BK4819_InitDTMF(void);
+void BK4819_PollEvents(void);
+bool BK4819_GetEvent(uint16_t *pStatus);
 bool BK4819_CheckSquelchLink(void);
 void BK4819_EnableTone1(bool bEnable);
 void BK4819_GenTail(bool bIsNarrow);
@@ -187,9 +187,7 @@ void SFLASH_Update(const void *pBuffer, uint32_t Address, uint16_t Size)
 	uint16_t Remaining;
 	uint16_t i;
 
-	gSPI_Lock = true;
-
-	HARDWARE_EnableInterrupts(false);
+	SFLASH_Lock();
 
 	Page = Address >> 12;
 	Offset = Address & 0xFFF;
@@ -225,6 +223,19 @@ void SFLASH_Update(const void *pBuffer, uint32_t Address, uint16_t Size)
 		}
 	}
 
+	SFLASH_Unlock();
+}
+
+// Keeps interrupts off across several flash commands
+void SFLASH_Lock(void)
+{
+	gSPI_Lock = true;
+
+	HARDWARE_EnableInterrupts(false);
+}
+
+void SFLASH_Unlock(void)
+{
 	HARDWARE_EnableInterrupts(true);
 
 	gSPI_Lock = false;
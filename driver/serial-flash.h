@@ -24,6 +24,8 @@ void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size);
 void SFLASH_Erase(uint32_t Page);
 void SFLASH_Write(const void *pBuffer, uint32_t Address, uint16_t Size);
 void SFLASH_Update(const void *pBuffer, uint32_t Address, uint16_t Size);
+void SFLASH_Lock(void);
+void SFLASH_Unlock(void);
 
 #endif
 
@@ -15,14 +15,76 @@
  */
 
 #include "driver/delay.h"
+#ifndef LCD_HOST_STUB
 #include "driver/pins.h"
+#endif
 #include "driver/st7735s.h"
 #include "ui/gfx.h"
 
+#ifdef UART_DEBUG
+uint32_t gLcdBusBytes;
+#endif
+
+#if defined(LCD_HOST_STUB)
+// Host builds hand every bus byte to the test harness instead of GPIOA.
+static bool bStubCommand;
+
+#define LCD_CS_LOW()
+#define LCD_CS_HIGH()
+#define LCD_DCX_LOW()	bStubCommand = true
+#define LCD_DCX_HIGH()	bStubCommand = false
+#define LCD_RES_LOW()
+#define LCD_RES_HIGH()
+
+static void SendByte(uint8_t Data)
+{
+	ST7735S_StubWrite(bStubCommand, Data);
+}
+#else
+#define LCD_CS_LOW()	gpio_bits_reset(GPIOC, BOARD_GPIOC_LCD_CS)
+#define LCD_CS_HIGH()	gpio_bits_set(GPIOC, BOARD_GPIOC_LCD_CS)
+#define LCD_DCX_LOW()	gpio_bits_reset(GPIOF, BOARD_GPIOF_LCD_DCX)
+#define LCD_DCX_HIGH()	gpio_bits_set(GPIOF, BOARD_GPIOF_LCD_DCX)
+#define LCD_RES_LOW()	gpio_bits_reset(GPIOF, GPIO_PINS_0)
+#define LCD_RES_HIGH()	gpio_bits_set(GPIOF, GPIO_PINS_0)
+
+#ifdef ENABLE_LCD_FAST_GPIO
+// PA0/PA4 can't be muxed to SPI1, so the fast path still bit-bangs the bus
+// but writes the port set/clear registers directly and unrolls the byte.
+#define SEND_BIT(Data, Bit) \
+	do { \
+		if ((Data) & (Bit)) { \
+			GPIOA->scr = BOARD_GPIOA_LCD_SDA; \
+		} else { \
+			GPIOA->clr = BOARD_GPIOA_LCD_SDA; \
+		} \
+		GPIOA->clr = BOARD_GPIOA_LCD_SCL; \
+		GPIOA->scr = BOARD_GPIOA_LCD_SCL; \
+	} while (0)
+
+static void SendByte(uint8_t Data)
+{
+#ifdef UART_DEBUG
+	gLcdBusBytes++;
+#endif
+	SEND_BIT(Data, 0x80U);
+	SEND_BIT(Data, 0x40U);
+	SEND_BIT(Data, 0x20U);
+	SEND_BIT(Data, 0x10U);
+	SEND_BIT(Data, 0x08U);
+	SEND_BIT(Data, 0x04U);
+	SEND_BIT(Data, 0x02U);
+	SEND_BIT(Data, 0x01U);
+}
+#else
 static void SendByte(uint8_t Data)
 {
 	uint8_t i;
 
+#ifdef UART_DEBUG
+	gLcdBusBytes++;
+#endif
+
 	for (i = 0; i < 8; i++) {
 		if (Data & 0x80U) {
 			gpio_bits_set(GPIOA, BOARD_GPIOA_LCD_SDA);
@@ -34,56 +96,93 @@ static void SendByte(uint8_t Data)
 		Data <<= 1;
 	}
 }
-
-static void WritePixel(uint16_t Color)
-{
-	ST7735S_SendCommand(ST7735S_CMD_RAMWR);
-	ST7735S_SendU16(Color);
-}
+#endif
+#endif
 
 void ST7735S_SendCommand(ST7735S_Command_t Command)
 {
-	gpio_bits_reset(GPIOF, BOARD_GPIOF_LCD_DCX);
-	gpio_bits_reset(GPIOC, BOARD_GPIOC_LCD_CS);
+	LCD_DCX_LOW();
+	LCD_CS_LOW();
 
 	SendByte(Command);
 
-	gpio_bits_set(GPIOC, BOARD_GPIOC_LCD_CS);
-	gpio_bits_set(GPIOF, BOARD_GPIOF_LCD_DCX);
+	LCD_CS_HIGH();
+	LCD_DCX_HIGH();
 }
 
 void ST7735S_SendData(uint8_t Data)
 {
-	gpio_bits_reset(GPIOC, BOARD_GPIOC_LCD_CS);
+	LCD_CS_LOW();
 
 	SendByte(Data);
 
-	gpio_bits_set(GPIOC, BOARD_GPIOC_LCD_CS);
+	LCD_CS_HIGH();
 }
 
-void ST7735S_SetPosition(uint8_t X, uint8_t Y)
+void ST7735S_SetWindow(uint8_t X0, uint8_t X1, uint8_t Y0, uint8_t Y1)
 {
+	// MADCTL 0xC8: screen X runs along the panel rows, Y along the columns.
 	ST7735S_SendCommand(ST7735S_CMD_CASET);
-	ST7735S_SendU16(Y);
+	ST7735S_SendU16(Y0);
+	ST7735S_SendU16(Y1);
 	ST7735S_SendCommand(ST7735S_CMD_RASET);
-	ST7735S_SendU16(X);
+	ST7735S_SendU16(X0);
+	ST7735S_SendU16(X1);
 	ST7735S_SendCommand(ST7735S_CMD_RAMWR);
 }
 
+void ST7735S_MoveWindowX(uint8_t X0, uint8_t X1)
+{
+	// Keeps the column range from the last ST7735S_SetWindow
+	ST7735S_SendCommand(ST7735S_CMD_RASET);
+	ST7735S_SendU16(X0);
+	ST7735S_SendU16(X1);
+	ST7735S_SendCommand(ST7735S_CMD_RAMWR);
+}
+
+void ST7735S_SetPosition(uint8_t X, uint8_t Y)
+{
+	ST7735S_SetWindow(X, 159, Y, 127);
+}
+
+void ST7735S_BeginPixels(void)
+{
+	LCD_CS_LOW();
+}
+
+void ST7735S_PushPixel(uint16_t Color)
+{
+	SendByte((Color >> 8) & 0xFF);
+	SendByte((Color >> 0) & 0xFF);
+}
+
+void ST7735S_PushPixels(uint16_t Color, uint16_t Count)
+{
+	while (Count--) {
+		SendByte((Color >> 8) & 0xFF);
+		SendByte((Color >> 0) & 0xFF);
+	}
+}
+
+void ST7735S_EndPixels(void)
+{
+	LCD_CS_HIGH();
+}
+
 void ST7735S_SendU16(uint16_t Data)
 {
-	gpio_bits_reset(GPIOC, BOARD_GPIOC_LCD_CS);
+	LCD_CS_LOW();
 
 	SendByte((Data >> 8) & 0xFF);
 	SendByte((Data >> 0) & 0xFF);
 
-	gpio_bits_set(GPIOC, BOARD_GPIOC_LCD_CS);
+	LCD_CS_HIGH();
 }
 
 void ST7735S_SetPixel(uint8_t X, uint8_t Y, uint16_t Color)
 {
-	ST7735S_SetPosition(X, Y);
-	WritePixel(Color);
+	ST7735S_SetWindow(X, X, Y, Y);
+	ST7735S_SendU16(Color);
 }
 
 void ST7735S_Init(void)
@@ -93,13 +192,13 @@ void ST7735S_Init(void)
 	gColorBackground = COLOR_RGB(0, 0, 0);
 	gColorForeground = COLOR_RGB(31, 63, 31);
 
-	gpio_bits_set(GPIOF, GPIO_PINS_0);
+	LCD_RES_HIGH();
 	DELAY_WaitMS(1);
 
-	gpio_bits_reset(GPIOF, GPIO_PINS_0);
+	LCD_RES_LOW();
 	DELAY_WaitMS(1);
 
-	gpio_bits_set(GPIOF, GPIO_PINS_0);
+	LCD_RES_HIGH();
 	DELAY_WaitMS(120);
 
 	ST7735S_SendCommand(ST7735S_CMD_SLPOUT);
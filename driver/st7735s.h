@@ -17,6 +17,7 @@
 #ifndef DRIVER_ST7735S_H
 #define DRIVER_ST7735S_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 enum ST7735S_Command_t {
@@ -79,10 +80,29 @@ enum ST7735S_Command_t {
 
 typedef enum ST7735S_Command_t ST7735S_Command_t;
 
+#ifdef UART_DEBUG
+// Bytes clocked out on the LCD bus, for comparing the cost of redraws.
+extern uint32_t gLcdBusBytes;
+#endif
+
+#ifdef LCD_HOST_STUB
+// Host test builds: every bus byte goes here, bCommand mirrors DCX low.
+void ST7735S_StubWrite(bool bCommand, uint8_t Data);
+#endif
+
 void ST7735S_SendCommand(ST7735S_Command_t Command);
 void ST7735S_SendData(uint8_t Data);
+void ST7735S_SetWindow(uint8_t X0, uint8_t X1, uint8_t Y0, uint8_t Y1);
+void ST7735S_MoveWindowX(uint8_t X0, uint8_t X1);
 void ST7735S_SetPosition(uint8_t X, uint8_t Y);
 void ST7735S_SendU16(uint16_t Data);
+
+// Pixel stream for the current window, CS is held low between Begin and End.
+void ST7735S_BeginPixels(void);
+void ST7735S_PushPixel(uint16_t Color);
+void ST7735S_PushPixels(uint16_t Color, uint16_t Count);
+void ST7735S_EndPixels(void);
+
 void ST7735S_SetPixel(uint8_t X, uint8_t Y, uint16_t Color);
 void ST7735S_Init(void);
 
@@ -21,6 +21,11 @@
 	#include "external/printf/printf.h"
 #endif
 
+static const uint8_t *pTxData;
+static volatile uint16_t TxLength;
+static volatile bool bAckPending;
+static uint8_t AckByte;
+
 static void usart_reset_ex(usart_type *uart, uint32_t baudrate)
 {
 	crm_clocks_freq_type info;
@@ -82,6 +87,49 @@ void UART_Send(const void *pBuffer, uint8_t Size)
 	}
 }
 
+// Sends from the caller's buffer on the TDBE interrupt. The buffer must stay
+// untouched until UART_IsSending() returns false.
+void UART_SendAsync(const void *pBuffer, uint16_t Size)
+{
+	if (Size == 0) {
+		return;
+	}
+	pTxData = (const uint8_t *)pBuffer;
+	TxLength = Size;
+	USART1->ctrl1_bit.tdbeien = TRUE;
+}
+
+// Command replies from the receive interrupt. While a frame is going out the
+// reply waits for its last byte instead of landing in the middle of it.
+void UART_SendAck(uint8_t Data)
+{
+	if (TxLength) {
+		AckByte = Data;
+		bAckPending = true;
+		return;
+	}
+	UART_SendByte(Data);
+}
+
+bool UART_IsSending(void)
+{
+	return TxLength != 0 || bAckPending;
+}
+
+void UART_HandleTx(void)
+{
+	if (TxLength) {
+		USART1->dt = *pTxData++;
+		TxLength--;
+	} else if (bAckPending) {
+		USART1->dt = AckByte;
+		bAckPending = false;
+	}
+	if (!TxLength && !bAckPending) {
+		USART1->ctrl1_bit.tdbeien = FALSE;
+	}
+}
+
 #ifdef UART_DEBUG
 	void UART_printf(const char *str, ...)
 	{
@@ -44,6 +44,23 @@ uint16_t TIMER_Calculate(uint16_t Setting)
 	return Setting * 5;
 }
 
+// CRC-16/CCITT-FALSE
+uint16_t CRC16_Calculate(const void *pBuffer, uint16_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint16_t Crc = 0xFFFF;
+	uint8_t i;
+
+	while (Size--) {
+		Crc ^= *pBytes++ << 8;
+		for (i = 0; i < 8; i++) {
+			Crc = (Crc & 0x8000) ? (Crc << 1) ^ 0x1021 : Crc << 1;
+		}
+	}
+
+	return Crc;
+}
+
 void SCREEN_TurnOn(void)
 {
 	if (gSettings.bEnableDisplay) {
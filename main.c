@@ -16,6 +16,9 @@
 
 #include <at32f421.h>
 #include "app/radio.h"
+#ifdef ENABLE_SPECTRUM
+	#include "app/spectrum.h"
+#endif
 #include "app/uart.h"
 #include "driver/bk4819.h"
 #include "driver/crm.h"
@@ -25,6 +28,7 @@
 #include "helper/helper.h"
 #include "misc.h"
 #include "radio/data.h"
+#include "radio/detector.h"
 #include "radio/hardware.h"
 #include "radio/settings.h"
 #include "task/am-fix.h"
@@ -44,6 +48,7 @@
 #include "task/rssi.h"
 #include "task/scanner.h"
 #include "task/screen.h"
+#include "task/settings.h"
 #include "task/sidekeys.h"
 #include "task/timeout.h"
 #include "task/voice.h"
@@ -72,6 +77,8 @@ void Main(void)
 		DATA_ReceiverInit();
 	}
 	while (1) {
+		uint16_t Status;
+
 		do {
 			while (!UART_IsRunning && gSettings.DtmfState != DTMF_STATE_KILLED) {
 				Task_VoicePlayer();
@@ -83,6 +90,7 @@ void Main(void)
 				Task_AM_fix();
 				#endif
 				Task_Scanner();
+				RADIO_CheckFrequencyDetect();
 				Task_CheckPTT();
 				Task_CheckIncoming();
 				Task_CheckRSSI();
@@ -97,11 +105,21 @@ void Main(void)
 				Task_CheckNOAA();
 #endif
 				Task_LocalAlarm();
+				Task_SaveSettings();
+				UART_CheckSession();
+#ifdef ENABLE_SPECTRUM
+				APP_SpectrumCheckStream();
+#endif
 			}
 		} while (gSettings.DtmfState != DTMF_STATE_KILLED);
-		if (BK4819_ReadRegister(0x0C) & 0x0001U) {
-			DATA_ReceiverCheck();
+
+		BK4819_PollEvents();
+		while (BK4819_GetEvent(&Status)) {
+			if (Status & BK4819_EVENT_IRQ) {
+				DATA_ReceiverCheck();
+			}
 		}
+		UART_CheckSession();
 		DELAY_WaitMS(1);
 		STANDBY_BlinkGreen();
 	}
@@ -54,5 +54,6 @@ char gBigString[40];
 
 uint32_t SFLASH_Offsets[20];
 uint32_t SFLASH_FontOffsets[32];
-uint8_t gFlashBuffer[8192];
+// Word aligned, modal apps such as the spectrum overlay their own buffers on it
+uint8_t gFlashBuffer[8192] __attribute__((aligned(4)));
 
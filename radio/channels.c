@@ -14,6 +14,7 @@
  *     limitations under the License.
  */
 
+#include <stddef.h>
 #include <string.h>
 #include "app/css.h"
 #include "app/fm.h"
@@ -25,6 +26,7 @@
 #include "helper/inputbox.h"
 #include "misc.h"
 #include "radio/channels.h"
+#include "radio/lockout.h"
 #include "radio/settings.h"
 #include "ui/helper.h"
 #ifdef ENABLE_NOAA
@@ -355,23 +357,267 @@ static const ChannelInfo_t gNoaaDefaultChannels[11] = {
 
 uint16_t gFreeChannelsCount;
 
-bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist) {
-	uint16_t startChannel = gSettings.VfoChNo[gSettings.CurrentVfo];
-	do {
-		if (Key == KEY_UP) {
-			gSettings.VfoChNo[gSettings.CurrentVfo] = CHANNELS_GetChannelUp(gSettings.VfoChNo[gSettings.CurrentVfo], gSettings.CurrentVfo);
+#define CHANNEL_NONE 0xFFFFU
+
+// One bit per memory channel: usable, and in the scan list ScanListIndex.
+// Next/previous channel lookups scan these instead of reading every record.
+static uint32_t ChannelUsed[32];
+static uint32_t ChannelInList[32];
+static uint8_t ScanListIndex = 0xFF;
+
+// What a receive-only tune needs from each member of the active scan list,
+// built when the list changes so scanner hops do not read the SPI flash. The
+// name and TX side are read once the scanner stops on a channel.
+#define SCAN_CACHE_SIZE 32
+#define SCAN_FLAGS_OFFSET (offsetof(ChannelInfo_t, TX) + sizeof(FrequencyInfo_t))
+// Golay to Scramble: CSS options, modulation, bandwidth, BCL and power
+#define SCAN_FLAGS_SIZE (offsetof(ChannelInfo_t, IsInscanList) - SCAN_FLAGS_OFFSET)
+
+typedef struct __attribute__((packed)) {
+	uint16_t Channel;
+	FrequencyInfo_t RX;
+	uint8_t Flags[SCAN_FLAGS_SIZE];
+} ScanEntry_t;
+
+static ScanEntry_t ScanCache[SCAN_CACHE_SIZE];
+static uint8_t ScanCacheCount;
+static bool bScanCacheValid;
+// Channel and VFO holding a cached copy without name and TX side
+static uint16_t PartialChannel = CHANNEL_NONE;
+static uint8_t PartialVfo;
+
+#ifdef UART_DEBUG
+uint32_t gScanCacheMisses;
+#endif
+
+static void SetChannelBit(uint32_t *pBitmap, uint16_t Channel, bool bSet)
+{
+	if (bSet) {
+		pBitmap[Channel >> 5] |= 1U << (Channel & 31);
+	} else {
+		pBitmap[Channel >> 5] &= ~(1U << (Channel & 31));
+	}
+}
+
+static bool IsChannelSkipped(const ChannelInfo_t *pChannel)
+{
+	uint32_t Frequency;
+
+	if (gSettings.bFLock) {
+		Frequency = pChannel->RX.Frequency;
+		if (Frequency > 44000000) {
+			return true;
+		}
+		if (Frequency > 14600000 && Frequency < 43000000) {
+			return true;
+		}
+		if (Frequency > 13600000 && Frequency < 14400000) {
+			return true;
+		}
+		if (Frequency < 10800000) {
+			return true;
+		}
+		Frequency = pChannel->TX.Frequency;
+		if (Frequency > 44000000) {
+			return true;
+		}
+		if (Frequency > 14600000 && Frequency < 43000000) {
+			return true;
+		}
+		if (Frequency > 13600000 && Frequency < 14400000) {
+			return true;
+		}
+		if (Frequency < 10800000) {
+			return true;
+		}
+	}
+
+	return pChannel->Available;
+}
+
+// Only the scan list byte of each used channel is read when the list changes
+static void UpdateScanListBitmap(void)
+{
+	uint8_t IsInscanList;
+	uint16_t i;
+
+	if (ScanListIndex == gExtendedSettings.CurrentScanList) {
+		return;
+	}
+	ScanListIndex = gExtendedSettings.CurrentScanList;
+	CHANNELS_InvalidateScanCache();
+	memset(ChannelInList, 0, sizeof(ChannelInList));
+	for (i = 0; i < 999; i++) {
+		if (ChannelUsed[i >> 5] & (1U << (i & 31))) {
+			SFLASH_Read(&IsInscanList, 0x3C2000 + (i * sizeof(ChannelInfo_t)) + offsetof(ChannelInfo_t, IsInscanList), 1);
+			SetChannelBit(ChannelInList, i, (IsInscanList >> ScanListIndex) & 1);
+		}
+	}
+}
+
+// Nearest usable channel after (or before) Channel, wrapping around and
+// ending on Channel itself. Bits above channel 998 are never set.
+static uint16_t FindChannel(uint16_t Channel, bool bUp, bool bScanList)
+{
+	uint16_t c;
+	uint32_t Word;
+	uint8_t i;
+
+	if (bUp) {
+		c = (Channel + 1) % 999;
+		for (i = 0; i <= 32; i++) {
+			Word = ChannelUsed[c >> 5] & (bScanList ? ChannelInList[c >> 5] : 0xFFFFFFFFU);
+			Word &= 0xFFFFFFFFU << (c & 31);
+			if (Word) {
+				return (c & ~31U) | __builtin_ctz(Word);
+			}
+			c = (c | 31U) + 1;
+			if (c >= 999) {
+				c = 0;
+			}
+		}
+	} else {
+		c = (Channel + 998) % 999;
+		for (i = 0; i <= 32; i++) {
+			Word = ChannelUsed[c >> 5] & (bScanList ? ChannelInList[c >> 5] : 0xFFFFFFFFU);
+			Word &= 0xFFFFFFFFU >> (31 - (c & 31));
+			if (Word) {
+				return (c & ~31U) | (31 - __builtin_clz(Word));
+			}
+			c = (c & ~31U) ? (c & ~31U) - 1 : 998;
+		}
+	}
+
+	return CHANNEL_NONE;
+}
+
+// Members in channel order, the first SCAN_CACHE_SIZE of longer lists
+static void BuildScanCache(void)
+{
+	ChannelInfo_t Info;
+	uint16_t i;
+
+	ScanCacheCount = 0;
+	bScanCacheValid = true;
+	for (i = 0; i < 999 && ScanCacheCount < SCAN_CACHE_SIZE; i++) {
+		if (!(ChannelUsed[i >> 5] & ChannelInList[i >> 5] & (1U << (i & 31)))) {
+			continue;
+		}
+		SFLASH_Read(&Info, 0x3C2000 + (i * sizeof(ChannelInfo_t)), offsetof(ChannelInfo_t, IsInscanList));
+		ScanCache[ScanCacheCount].Channel = i;
+		ScanCache[ScanCacheCount].RX = Info.RX;
+		memcpy(ScanCache[ScanCacheCount].Flags, (const uint8_t *)&Info + SCAN_FLAGS_OFFSET, SCAN_FLAGS_SIZE);
+		ScanCacheCount++;
+	}
+}
+
+static const ScanEntry_t *FindScanEntry(uint16_t Channel)
+{
+	uint8_t Low = 0;
+	uint8_t High = ScanCacheCount;
+	uint8_t Middle;
+
+	while (Low < High) {
+		Middle = (Low + High) / 2;
+		if (ScanCache[Middle].Channel == Channel) {
+			return &ScanCache[Middle];
+		}
+		if (ScanCache[Middle].Channel < Channel) {
+			Low = Middle + 1;
 		} else {
-			gSettings.VfoChNo[gSettings.CurrentVfo] = CHANNELS_GetChannelDown(gSettings.VfoChNo[gSettings.CurrentVfo], gSettings.CurrentVfo);
+			High = Middle;
 		}
-		if (gSettings.VfoChNo[gSettings.CurrentVfo] == startChannel)
+	}
+
+	return NULL;
+}
+
+// Reversal receives on the TX side, which the cache does not hold
+static void LoadScanChannel(uint16_t Channel, uint8_t Vfo, bool bScanList)
+{
+	ChannelInfo_t *pInfo = &gVfoState[Vfo];
+	const ScanEntry_t *pEntry = NULL;
+
+	if (bScanList && gSettings.RepeaterMode != 2) {
+		if (!bScanCacheValid) {
+			BuildScanCache();
+		}
+		pEntry = FindScanEntry(Channel);
+	}
+	if (pEntry == NULL) {
+#ifdef UART_DEBUG
+		gScanCacheMisses++;
+#endif
+		CHANNELS_LoadChannel(Channel, Vfo);
+		return;
+	}
+	pInfo->RX = pEntry->RX;
+	pInfo->TX = pEntry->RX;
+	memcpy((uint8_t *)pInfo + SCAN_FLAGS_OFFSET, pEntry->Flags, SCAN_FLAGS_SIZE);
+	pInfo->IsInscanList = 1U << ScanListIndex;
+	memset(pInfo->Name, ' ', sizeof(pInfo->Name));
+	PartialChannel = Channel;
+	PartialVfo = Vfo;
+}
+
+void CHANNELS_InvalidateScanCache(void)
+{
+	bScanCacheValid = false;
+}
+
+// Reads the rest of a channel the scanner stopped on, true when it did
+bool CHANNELS_CompleteScanChannel(void)
+{
+	if (PartialChannel == CHANNEL_NONE) {
+		return false;
+	}
+	CHANNELS_LoadChannel(PartialChannel, PartialVfo);
+
+	return true;
+}
+
+// RX frequency of a usable memory channel, 0 otherwise
+uint32_t CHANNELS_GetRxFrequency(uint16_t Channel)
+{
+	uint32_t Frequency = 0;
+
+	if (Channel < 999 && (ChannelUsed[Channel >> 5] & (1U << (Channel & 31)))) {
+		SFLASH_Read(&Frequency, 0x3C2000 + (Channel * sizeof(ChannelInfo_t)) + offsetof(ChannelInfo_t, RX.Frequency), sizeof(Frequency));
+	}
+
+	return Frequency;
+}
+
+bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist) {
+	const uint16_t startChannel = gSettings.VfoChNo[gSettings.CurrentVfo];
+	uint16_t Channel = startChannel;
+	uint16_t firstChannel = CHANNEL_NONE;
+
+	if (OnlyFromScanlist) {
+		UpdateScanListBitmap();
+	}
+	// Locked out frequencies are stepped over while scanning
+	do {
+		Channel = FindChannel(Channel, Key == KEY_UP, OnlyFromScanlist);
+		// Back to the start, or round a list the start is not in: nothing else to scan
+		if (Channel == CHANNEL_NONE || Channel == startChannel || Channel == firstChannel) {
+			if (Channel != CHANNEL_NONE) {
+				LoadScanChannel(startChannel, gSettings.CurrentVfo, OnlyFromScanlist);
+			}
 			return false;	// empty list
-	} while (OnlyFromScanlist && !((gVfoState[gSettings.CurrentVfo].IsInscanList >> gExtendedSettings.CurrentScanList) & 1));
+		}
+		if (firstChannel == CHANNEL_NONE) {
+			firstChannel = Channel;
+		}
+		LoadScanChannel(Channel, gSettings.CurrentVfo, OnlyFromScanlist);
+	} while (gScannerMode && LOCKOUT_Contains(gVfoState[gSettings.CurrentVfo].RX.Frequency));
+	gSettings.VfoChNo[gSettings.CurrentVfo] = Channel;
 	RADIO_Tune(gSettings.CurrentVfo);
 	UI_DrawVfo(gSettings.CurrentVfo);
 	return true;
 }
 
-void CHANNELS_NextChannelVfo(uint8_t Key)
+static void StepVfo(uint8_t Key)
 {
 	ChannelInfo_t *pInfo = &gVfoState[gSettings.CurrentVfo];
 
@@ -461,6 +707,19 @@ void CHANNELS_NextChannelVfo(uint8_t Key)
 		}
 		gVfoInfo[gSettings.CurrentVfo].Frequency = pInfo->TX.Frequency;
 	}
+}
+
+void CHANNELS_NextChannelVfo(uint8_t Key)
+{
+	uint8_t i;
+
+	// Locked out frequencies are stepped over while scanning
+	for (i = 0; i <= LOCKOUT_MAX; i++) {
+		StepVfo(Key);
+		if (!gScannerMode || !LOCKOUT_Contains(gVfoState[gSettings.CurrentVfo].RX.Frequency)) {
+			break;
+		}
+	}
 
 	UI_DrawVfo(gSettings.CurrentVfo);
 }
@@ -584,39 +843,12 @@ void CHANNELS_UpdateVFO(void)
 
 bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo)
 {
-	uint32_t Frequency;
-
-	SFLASH_Read(&gVfoState[Vfo], 0x3C2000 + (ChNo * sizeof(ChannelInfo_t)), sizeof(ChannelInfo_t));
-	if (gSettings.bFLock) {
-		Frequency = gVfoState[Vfo].RX.Frequency;
-		if (Frequency > 44000000) {
-			return true;
-		}
-		if (Frequency > 14600000 && Frequency < 43000000) {
-			return true;
-		}
-		if (Frequency > 13600000 && Frequency < 14400000) {
-			return true;
-		}
-		if (Frequency < 10800000) {
-			return true;
-		}
-		Frequency = gVfoState[Vfo].TX.Frequency;
-		if (Frequency > 44000000) {
-			return true;
-		}
-		if (Frequency > 14600000 && Frequency < 43000000) {
-			return true;
-		}
-		if (Frequency > 13600000 && Frequency < 14400000) {
-			return true;
-		}
-		if (Frequency < 10800000) {
-			return true;
-		}
+	if (Vfo == PartialVfo) {
+		PartialChannel = CHANNEL_NONE;
 	}
+	SFLASH_Read(&gVfoState[Vfo], 0x3C2000 + (ChNo * sizeof(ChannelInfo_t)), sizeof(ChannelInfo_t));
 
-	return gVfoState[Vfo].Available;
+	return IsChannelSkipped(&gVfoState[Vfo]);
 }
 
 void CHANNELS_CheckFreeChannels(void)
@@ -624,9 +856,15 @@ void CHANNELS_CheckFreeChannels(void)
 	uint16_t i;
 
 	gFreeChannelsCount = 0;
+	CHANNELS_InvalidateScanCache();
+	memset(ChannelUsed, 0, sizeof(ChannelUsed));
+	memset(ChannelInList, 0, sizeof(ChannelInList));
+	ScanListIndex = gExtendedSettings.CurrentScanList;
 	for (i = 0; i < 999; i++) {
 		if (!CHANNELS_LoadChannel(i, 0)) {
 			gFreeChannelsCount++;
+			SetChannelBit(ChannelUsed, i, true);
+			SetChannelBit(ChannelInList, i, (gVfoState[0].IsInscanList >> ScanListIndex) & 1);
 		}
 	}
 	if (gFreeChannelsCount == 0) {
@@ -678,28 +916,24 @@ void CHANNELS_LoadWorkMode(void)
 
 uint16_t CHANNELS_GetChannelUp(uint16_t Channel, uint8_t Vfo)
 {
-	Channel++;
-	while (1) {
-		Channel %= 999;
-		if (!CHANNELS_LoadChannel(Channel, Vfo)) {
-			break;
-		}
-		Channel++;
+	const uint16_t Next = FindChannel(Channel, true, false);
+
+	if (Next != CHANNEL_NONE) {
+		Channel = Next;
 	}
+	CHANNELS_LoadChannel(Channel, Vfo);
 
 	return Channel;
 }
 
 uint16_t CHANNELS_GetChannelDown(uint16_t Channel, uint8_t Vfo)
 {
-	Channel += 998;
-	while (1) {
-		Channel %= 999;
-		if (!CHANNELS_LoadChannel(Channel, Vfo)) {
-			break;
-		}
-		Channel += 998;
+	const uint16_t Next = FindChannel(Channel, false, false);
+
+	if (Next != CHANNEL_NONE) {
+		Channel = Next;
 	}
+	CHANNELS_LoadChannel(Channel, Vfo);
 
 	return Channel;
 }
@@ -707,6 +941,18 @@ uint16_t CHANNELS_GetChannelDown(uint16_t Channel, uint8_t Vfo)
 void CHANNELS_SaveChannel(uint16_t Channel, const ChannelInfo_t *pChannel)
 {
 	SFLASH_Update(pChannel, 0x3C2000 + (Channel * sizeof(*pChannel)), sizeof(*pChannel));
+	CHANNELS_InvalidateScanCache();
+
+	// Memory channels only, 999 and 1000 are the VFOs
+	if (Channel < 999) {
+		const bool bUsed = !IsChannelSkipped(pChannel);
+
+		if (bUsed != ((ChannelUsed[Channel >> 5] >> (Channel & 31)) & 1)) {
+			gFreeChannelsCount += bUsed ? 1 : -1;
+		}
+		SetChannelBit(ChannelUsed, Channel, bUsed);
+		SetChannelBit(ChannelInList, Channel, bUsed && ScanListIndex < 8 && ((pChannel->IsInscanList >> ScanListIndex) & 1));
+	}
 }
 
 #ifdef ENABLE_NOAA
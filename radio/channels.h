@@ -52,6 +52,9 @@ typedef struct __attribute__((packed)) {
 } ChannelInfo_t;
 
 extern uint16_t gFreeChannelsCount;
+#ifdef UART_DEBUG
+extern uint32_t gScanCacheMisses;
+#endif
 
 bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist);
 void CHANNELS_NextChannelVfo(uint8_t Key);
@@ -69,6 +72,9 @@ void CHANNELS_LoadVfoMode(void);
 void CHANNELS_LoadWorkMode(void);
 uint16_t CHANNELS_GetChannelUp(uint16_t Channel, uint8_t Vfo);
 uint16_t CHANNELS_GetChannelDown(uint16_t Channel, uint8_t Vfo);
+void CHANNELS_InvalidateScanCache(void);
+bool CHANNELS_CompleteScanChannel(void);
+uint32_t CHANNELS_GetRxFrequency(uint16_t Channel);
 void CHANNELS_SaveChannel(uint16_t Channel, const ChannelInfo_t *pChannel);
 #ifdef ENABLE_NOAA
 void CHANNELS_SetNoaaChannel(uint8_t Channel);
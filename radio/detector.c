@@ -19,7 +19,6 @@
 #include "driver/audio.h"
 #include "driver/beep.h"
 #include "driver/bk4819.h"
-#include "driver/delay.h"
 #include "driver/key.h"
 #include "driver/pins.h"
 #include "driver/speaker.h"
@@ -28,13 +27,34 @@
 #include "radio/detector.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
-#include "task/incoming.h"
 #include "task/ptt.h"
-#include "task/rssi.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
 #include "ui/main.h"
 
+// Frequency counter, then CTCSS/DCS detection, stepped once per scheduler
+// tick so the rest of the firmware keeps running.
+enum {
+	DETECT_IDLE = 0,
+	DETECT_SCAN,		// frequency counter running, waiting for REG_0D
+	DETECT_WAIT_LINK,	// tuned to the hit (or CTDC channel), waiting for squelch
+	DETECT_CSS_SETTLE,	// CSS detection just reconfigured
+	DETECT_CSS,			// waiting for REG_68/69
+	DETECT_LISTEN,		// normal RX on the detected settings
+};
+
+// REG_0D still holds the previous count right after a (re)start
+#define DETECT_SCAN_GATE_MS		200U
+#define DETECT_SCAN_TIMEOUT_MS	1000U
+#define DETECT_RESCAN_MS		105U
+#define DETECT_CSS_SETTLE_MS	200U
+#define DETECT_CSS_TIMEOUT_MS	1000U
+
+static uint8_t DetectState;
+static uint32_t DetectStateTime;
+static bool bCtdcScan;
+static bool bFound;
+
 //
 
 static uint32_t RoundToNearest50(uint32_t Frequency)
@@ -52,20 +72,10 @@ static uint32_t RoundToNearest50(uint32_t Frequency)
 static bool CheckScanResult(void)
 {
 	uint32_t Frequency;
-	uint16_t Timeout;
 	uint16_t Result;
 
-	Timeout = 1000;
-	while (Timeout) {
-		DELAY_WaitMS(1);
-		Result = BK4819_ReadRegister(0x0D);
-		if ((Result & 0x8000U) == 0) {
-			break;
-		}
-		Timeout--;
-	}
-
-	if (!Timeout) {
+	Result = BK4819_ReadRegister(0x0D);
+	if (Result & 0x8000U) {
 		return false;
 	}
 
@@ -162,204 +172,128 @@ static bool GetDcsCode(uint32_t Golay)
 	return false;
 }
 
-static void MuteCtcssScan(void)
+static void SetState(uint8_t State)
+{
+	DetectState = State;
+	DetectStateTime = gTimeSinceBoot;
+}
+
+static uint32_t StateElapsed(void)
 {
-	uint16_t Timeout = 1000;
+	return gTimeSinceBoot - DetectStateTime;
+}
 
-	while (1) {
-		uint32_t Code;
+// Returns true once REG_69 (DCS/CDCSS) or REG_68 (CTCSS) has given a usable code
+static bool CheckCssResult(void)
+{
+	uint32_t Code;
 
-		if (Timeout == 0) {
-			VFO_ClearMute();
-			VFO_ClearCss();
-			UI_DrawNone();
-			break;
+	Code = BK4819_ReadRegister(0x69);
+	if ((Code & 0x8000U) == 0) {
+		if (Code & 0x4000U) {
+			gVfoState[gSettings.CurrentVfo].bIs24Bit = 1;
+		} else {
+			gVfoState[gSettings.CurrentVfo].bIs24Bit = 0;
 		}
-		DELAY_WaitMS(1);
-		Code = BK4819_ReadRegister(0x69);
-		Timeout--;
-		if ((Code & 0x8000U) == 0) {
-			if (Code & 0x4000U) {
-				gVfoState[gSettings.CurrentVfo].bIs24Bit = 1;
-			} else {
-				gVfoState[gSettings.CurrentVfo].bIs24Bit = 0;
-			}
 
-			// Double check the assembly, it didn't make sense!
-			Code = (Code & 0xFFF) << 12;
-			Code |= BK4819_ReadRegister(0x6A) & 0xFFF;
-			gVfoState[gSettings.CurrentVfo].Golay = Code;
-
-			if ((Code & 0xFFFFFF) != 0x555555 && (Code & 0xFFFFFF) != 0xAAAAAA) {
-				if (Code != 0x800000 && (Code & 0xFFFFFF) != 0xFFFFFF && (Code & 0xFFFFFF) != 0x7FFFFF) {
-					if (!gVfoState[gSettings.CurrentVfo].bIs24Bit) {
-						Code &= 0x7FFFFF;
-						gVfoState[gSettings.CurrentVfo].Golay = Code;
-						if (GetDcsCode(Code)) {
-							VFO_ClearMute();
-							break;
-						}
+		// Double check the assembly, it didn't make sense!
+		Code = (Code & 0xFFF) << 12;
+		Code |= BK4819_ReadRegister(0x6A) & 0xFFF;
+		gVfoState[gSettings.CurrentVfo].Golay = Code;
+
+		if ((Code & 0xFFFFFF) != 0x555555 && (Code & 0xFFFFFF) != 0xAAAAAA) {
+			if (Code != 0x800000 && (Code & 0xFFFFFF) != 0xFFFFFF && (Code & 0xFFFFFF) != 0x7FFFFF) {
+				if (!gVfoState[gSettings.CurrentVfo].bIs24Bit) {
+					Code &= 0x7FFFFF;
+					gVfoState[gSettings.CurrentVfo].Golay = Code;
+					if (GetDcsCode(Code)) {
+						VFO_ClearMute();
+						return true;
 					}
-					gVfoState[gSettings.CurrentVfo].bMuteEnabled = 1;
-					UI_DrawMuteInfo(gVfoState[gSettings.CurrentVfo].bIs24Bit, gVfoState[gSettings.CurrentVfo].Golay);
-				} else {
-					VFO_ClearMute();
-					VFO_ClearCss();
-					UI_DrawNone();
 				}
-				break;
+				gVfoState[gSettings.CurrentVfo].bMuteEnabled = 1;
+				UI_DrawMuteInfo(gVfoState[gSettings.CurrentVfo].bIs24Bit, gVfoState[gSettings.CurrentVfo].Golay);
+			} else {
+				VFO_ClearMute();
+				VFO_ClearCss();
+				UI_DrawNone();
 			}
+			return true;
 		}
-		VFO_ClearMute();
-		Code = BK4819_ReadRegister(0x68);
-		if ((Code & 0x8000U) == 0) {
-			Code = (((Code & 0x1FFFU) * 200U) / 413U) + 1U;
-			if (Code > 500) {
-				Code &= 0xFFFU;
-				gVfoState[gSettings.CurrentVfo].RX.Code = Code;
-				gVfoState[gSettings.CurrentVfo].TX.Code = Code;
-				gVfoState[gSettings.CurrentVfo].RX.CodeType = CODE_TYPE_CTCSS;
-				gVfoState[gSettings.CurrentVfo].TX.CodeType = CODE_TYPE_CTCSS;
-				UI_DrawCtcssCode(Code);
-				break;
-			}
+	}
+	VFO_ClearMute();
+	Code = BK4819_ReadRegister(0x68);
+	if ((Code & 0x8000U) == 0) {
+		Code = (((Code & 0x1FFFU) * 200U) / 413U) + 1U;
+		if (Code > 500) {
+			Code &= 0xFFFU;
+			gVfoState[gSettings.CurrentVfo].RX.Code = Code;
+			gVfoState[gSettings.CurrentVfo].TX.Code = Code;
+			gVfoState[gSettings.CurrentVfo].RX.CodeType = CODE_TYPE_CTCSS;
+			gVfoState[gSettings.CurrentVfo].TX.CodeType = CODE_TYPE_CTCSS;
+			UI_DrawCtcssCode(Code);
+			return true;
 		}
 	}
+
+	return false;
 }
 
-static void DETECTOR_Loop(void)
+static void StartScan(void)
 {
-	bool bCtdcScan;
-	bool bScan;
-	KEY_t Key;
+	bFound = false;
+	BK4819_StartFrequencyScan();
+	SetState(DETECT_SCAN);
+}
 
-	bCtdcScan = false;
-	bScan = false;
-
-	while (1) {
-		DISPLAY_Fill(80, 159, 8, 40, COLOR_BACKGROUND);
-		gRxLinkCounter = 0;
-		do {
-			if (gRxLinkCounter == 0 && !bCtdcScan) {
-				BK4819_StartFrequencyScan();
-				bScan = CheckScanResult();
-				BK4819_StopFrequencyScan();
-				if (bScan) {
-					RADIO_Tune(gSettings.CurrentVfo);
-				}
-			}
-			DELAY_WaitMS(5);
-			if (gRxLinkCounter++ > 20) {
-				gRxLinkCounter = 0;
-			}
-			Key = KEY_GetButton();
-			if (Key == KEY_NONE) {
-				if (KEY_KeyCounter > 10) {
-					KEY_KeyCounter = 0;
-					if (KEY_CurrentKey == KEY_HASH && !bCtdcScan) {
-						KEY_CurrentKey = KEY_NONE;
-						UpdateBand(true);
-					} else if (KEY_CurrentKey == KEY_STAR) {
-						KEY_CurrentKey = KEY_NONE;
-						if (!bCtdcScan) {
-							CtdcScan();
-							bCtdcScan = true;
-						} else {
-							UpdateBand(false);
-							bCtdcScan = false;
-						}
-					}
-				}
-				KEY_KeyCounter = 0;
-				KEY_CurrentKey = KEY_NONE;
-				Key = KEY_CurrentKey;
-			}
-			KEY_CurrentKey = Key;
-		} while ((!bScan || !BK4819_CheckSquelchLink()) && gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT));
+static void Restart(void)
+{
+	DISPLAY_Fill(80, 159, 8, 40, COLOR_BACKGROUND);
+	gRxLinkCounter = 0;
+	if (bCtdcScan) {
+		SetState(DETECT_WAIT_LINK);
+	} else {
+		StartScan();
+	}
+}
 
-		if (!gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT)) {
-			gPttPressed = true;
-			KEY_SideKeyLongPressed = false;
-			KEY_KeyCounter = 0;
-			StopDetect();
-			BEEP_Play(440, 4, 80);
-			return;
-		}
-		BK4819_DisableAutoCssBW();
-		MuteCtcssScan();
-		KEY_CurrentKey = KEY_NONE;
-		RADIO_Tune(gSettings.CurrentVfo);
-		gSignalFound = false;
-		Key = KEY_CurrentKey;
-		while (1) {
-			KEY_CurrentKey = Key;
-			if (!gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT)) {
-				gPttPressed = true;
-				KEY_SideKeyLongPressed = false;
-				KEY_KeyCounter = 0;
-				StopDetect();
-				BEEP_Play(440, 4, 80);
-				return;
-			}
-			Key = KEY_GetButton();
-			Task_CheckIncoming();
-			Task_CheckRSSI();
-			if (bCtdcScan && gSignalFound && gRadioMode != RADIO_MODE_QUIET && gDetectorTimer == 0) {
-				CtdcScan();
-				break;
-			}
-			if (Key == KEY_NONE) {
-				if (KEY_KeyCounter > 50) {
-					KEY_KeyCounter = 0;
-					if (KEY_CurrentKey == KEY_MENU) {
-						KEY_CurrentKey = KEY_NONE;
-						RADIO_EndRX();
-						gSettings.WorkMode = 0;
-						SETTINGS_SaveGlobals();
-						RADIO_SaveCurrentVfo();
-						KEY_SideKeyLongPressed = false;
-						KEY_KeyCounter = 0;
-						StopDetect();
-						BEEP_Play(740, 3, 80);
-						return;
-					}
-					if (KEY_CurrentKey == KEY_EXIT) {
-						KEY_CurrentKey = KEY_NONE;
-						RADIO_EndRX();
-						BEEP_Play(740, 2, 100);
-						break;
-					}
-					if (KEY_CurrentKey == KEY_HASH && !bCtdcScan) {
-						KEY_CurrentKey = KEY_NONE;
-						RADIO_EndRX();
-						UpdateBand(true);
-						break;
-					}
-					if (KEY_CurrentKey == KEY_STAR) {
-						KEY_CurrentKey = KEY_NONE;
-						RADIO_EndRX();
-						if (!bCtdcScan) {
-							CtdcScan();
-							bCtdcScan = true;
-						} else {
-							UpdateBand(false);
-							bCtdcScan = false;
-						}
-						break;
-					}
-				}
-				KEY_KeyCounter = 0;
-				KEY_CurrentKey = KEY_NONE;
-				Key = KEY_CurrentKey;
-			}
-		}
+static void ToggleCtdcScan(void)
+{
+	if (!bCtdcScan) {
+		CtdcScan();
+		bCtdcScan = true;
+		// The channel is already tuned, only a carrier is needed
+		bFound = true;
+	} else {
+		UpdateBand(false);
+		bCtdcScan = false;
 	}
 }
 
+static void Finish(void)
+{
+	if (DetectState == DETECT_SCAN) {
+		BK4819_StopFrequencyScan();
+	}
+	DetectState = DETECT_IDLE;
+	StopDetect();
+	gScreenMode = SCREEN_MAIN;
+}
+
+static void FinishCss(void)
+{
+	RADIO_Tune(gSettings.CurrentVfo);
+	gSignalFound = false;
+	SetState(DETECT_LISTEN);
+}
+
 //
 
 void RADIO_FrequencyDetect(void)
 {
+	if (gRadioMode == RADIO_MODE_RX) {
+		RADIO_EndRX();
+	}
 	gScreenMode = SCREEN_FREQ_DETECT;
 	SPEAKER_State = 0;
 	gpio_bits_reset(GPIOA, BOARD_GPIOA_SPEAKER);
@@ -372,7 +306,143 @@ void RADIO_FrequencyDetect(void)
 	VFO_ClearCss();
 	VFO_ClearMute();
 	BK4819_EnableFilter(true);
-	DETECTOR_Loop();
-	gScreenMode = SCREEN_MAIN;
+	bCtdcScan = false;
+	Restart();
+}
+
+void RADIO_CheckFrequencyDetect(void)
+{
+	if (DetectState == DETECT_IDLE || !SCHEDULER_CheckTask(TASK_FREQUENCY_DETECT)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_FREQUENCY_DETECT);
+
+	if (!gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT)) {
+		gPttPressed = true;
+		KEY_SideKeyLongPressed = false;
+		KEY_KeyCounter = 0;
+		Finish();
+		BEEP_Play(440, 4, 80);
+		return;
+	}
+
+	if (DetectState != DETECT_LISTEN) {
+		// Keep Task_CheckIncoming off the radio until there is something to listen to
+		gIncomingTimer = 2;
+	}
+
+	switch (DetectState) {
+	case DETECT_SCAN:
+		if (StateElapsed() < DETECT_SCAN_GATE_MS) {
+			break;
+		}
+		if (CheckScanResult()) {
+			BK4819_StopFrequencyScan();
+			RADIO_Tune(gSettings.CurrentVfo);
+			bFound = true;
+			SetState(DETECT_WAIT_LINK);
+		} else if (StateElapsed() >= DETECT_SCAN_GATE_MS + DETECT_SCAN_TIMEOUT_MS) {
+			BK4819_StopFrequencyScan();
+			SetState(DETECT_WAIT_LINK);
+		}
+		break;
+
+	case DETECT_WAIT_LINK:
+		if (bFound && BK4819_CheckSquelchLink()) {
+			BK4819_DisableAutoCssBW();
+			SetState(DETECT_CSS_SETTLE);
+		} else if (!bCtdcScan && StateElapsed() >= DETECT_RESCAN_MS) {
+			StartScan();
+		}
+		break;
+
+	case DETECT_CSS_SETTLE:
+		if (StateElapsed() >= DETECT_CSS_SETTLE_MS) {
+			BK4819_EnableRX();
+			SetState(DETECT_CSS);
+		}
+		break;
+
+	case DETECT_CSS:
+		if (CheckCssResult()) {
+			FinishCss();
+		} else if (StateElapsed() >= DETECT_CSS_TIMEOUT_MS) {
+			VFO_ClearMute();
+			VFO_ClearCss();
+			UI_DrawNone();
+			FinishCss();
+		}
+		break;
+
+	case DETECT_LISTEN:
+		if (bCtdcScan && gSignalFound && gRadioMode != RADIO_MODE_QUIET && gDetectorTimer == 0) {
+			CtdcScan();
+			Restart();
+		}
+		break;
+
+	default:
+		break;
+	}
 }
 
+void DETECTOR_KeyHandler(KEY_t Key)
+{
+	switch (DetectState) {
+	case DETECT_SCAN:
+	case DETECT_WAIT_LINK:
+		if (Key == KEY_HASH && !bCtdcScan) {
+			UpdateBand(true);
+		} else if (Key == KEY_STAR) {
+			if (DetectState == DETECT_SCAN) {
+				BK4819_StopFrequencyScan();
+			}
+			ToggleCtdcScan();
+			Restart();
+		}
+		break;
+
+	case DETECT_LISTEN:
+		switch (Key) {
+		case KEY_MENU:
+			RADIO_EndRX();
+			gSettings.WorkMode = 0;
+			SETTINGS_SaveGlobals();
+			RADIO_SaveCurrentVfo();
+			KEY_SideKeyLongPressed = false;
+			KEY_KeyCounter = 0;
+			Finish();
+			BEEP_Play(740, 3, 80);
+			break;
+
+		case KEY_EXIT:
+			RADIO_EndRX();
+			BEEP_Play(740, 2, 100);
+			Restart();
+			break;
+
+		case KEY_HASH:
+			if (!bCtdcScan) {
+				RADIO_EndRX();
+				UpdateBand(true);
+				Restart();
+			}
+			break;
+
+		case KEY_STAR:
+			RADIO_EndRX();
+			ToggleCtdcScan();
+			Restart();
+			break;
+
+		default:
+			break;
+		}
+		break;
+
+	default:
+		// The CSS steps take well under two seconds, keys wait for them
+		break;
+	}
+}
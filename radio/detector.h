@@ -17,7 +17,11 @@
 #ifndef RADIO_DETECTOR_H
 #define RADIO_DETECTOR_H
 
+#include "driver/key.h"
+
 void RADIO_FrequencyDetect(void);
+void RADIO_CheckFrequencyDetect(void);
+void DETECTOR_KeyHandler(KEY_t Key);
 
 #endif
 
@@ -27,6 +27,7 @@
 #include "driver/uart.h"
 #include "radio/hardware.h"
 #include "radio/scheduler.h"
+#include "radio/settings.h"
 #include "ui/gfx.h"
 
 typedef struct {
@@ -197,6 +198,7 @@ void HARDWARE_Init(void)
 
 void HARDWARE_Reboot(void)
 {
+	SETTINGS_FlushGlobals();
 	DELAY_WaitMS(1000);
 	DISPLAY_Fill(0, 159, 0, 96, COLOR_BACKGROUND);
 	RADIO_Sleep();
@@ -0,0 +1,193 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "driver/serial-flash.h"
+#include "helper/helper.h"
+#include "radio/journal.h"
+#include "radio/settings.h"
+
+// gSettings and gExtendedSettings are appended as records across two spare
+// sectors, so a save programs one slot instead of rewriting two sectors.
+// The newest valid record wins at boot, the fixed locations are the fallback
+// and what the programming software sees.
+#define JOURNAL_ADDRESS		0x3D6000U
+#define JOURNAL_SECTORS		2U
+#define JOURNAL_SLOT_SIZE	128U
+#define JOURNAL_SLOTS		(0x1000U / JOURNAL_SLOT_SIZE)
+#define JOURNAL_MAGIC		0x4AU
+// Records of any other version are ignored, bump it when the layout changes
+#define JOURNAL_VERSION		2U
+
+typedef struct {
+	// Programmed last, so a record cut short by a power loss never looks valid
+	uint8_t Magic;
+	uint8_t Version;
+	uint16_t Crc;
+	uint32_t Sequence;
+	gSettings_t Settings;
+	gExtendedSettings_t Extended;
+} JournalRecord_t;
+
+_Static_assert(sizeof(JournalRecord_t) <= JOURNAL_SLOT_SIZE, "Journal record too big");
+
+static uint8_t JournalSector;
+static uint8_t JournalSlot = JOURNAL_SLOTS;
+static uint32_t JournalSequence;
+static uint32_t JournalLast;
+
+static uint32_t GetSlotAddress(uint8_t Sector, uint8_t Slot)
+{
+	return JOURNAL_ADDRESS + (Sector * 0x1000U) + (Slot * JOURNAL_SLOT_SIZE);
+}
+
+static uint16_t GetRecordCrc(const JournalRecord_t *pRecord)
+{
+	return CRC16_Calculate(&pRecord->Sequence, sizeof(*pRecord) - 4);
+}
+
+static bool IsBlank(const void *pBuffer, uint16_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+
+	while (Size--) {
+		if (*pBytes++ != 0xFF) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Finds the newest valid record and the first free slot after it. Slots are
+// filled in order, so a torn or corrupt slot is simply skipped.
+void JOURNAL_Load(void)
+{
+	JournalRecord_t Record;
+	uint8_t Sector;
+	uint8_t Slot;
+
+	for (Sector = 0; Sector < JOURNAL_SECTORS; Sector++) {
+		for (Slot = 0; Slot < JOURNAL_SLOTS; Slot++) {
+			const uint32_t Address = GetSlotAddress(Sector, Slot);
+
+			SFLASH_Read(&Record, Address, sizeof(Record));
+			if (IsBlank(&Record, sizeof(Record))) {
+				break;
+			}
+			if (Record.Magic != JOURNAL_MAGIC || Record.Version != JOURNAL_VERSION || Record.Crc != GetRecordCrc(&Record)) {
+				continue;
+			}
+			if (JournalLast == 0 || Record.Sequence > JournalSequence) {
+				JournalSequence = Record.Sequence;
+				JournalLast = Address;
+				JournalSector = Sector;
+				gSettings = Record.Settings;
+				gExtendedSettings = Record.Extended;
+			}
+		}
+	}
+
+	// Nothing valid yet: start on a freshly erased sector
+	if (JournalLast == 0) {
+		return;
+	}
+	for (Slot = JOURNAL_SLOTS; Slot > 0; Slot--) {
+		SFLASH_Read(&Record, GetSlotAddress(JournalSector, Slot - 1), sizeof(Record));
+		if (!IsBlank(&Record, sizeof(Record))) {
+			break;
+		}
+	}
+	JournalSlot = Slot;
+}
+
+bool JOURNAL_Save(void)
+{
+	JournalRecord_t Record;
+	JournalRecord_t Check;
+	uint32_t Address = 0;
+	uint8_t Tries;
+
+	Record.Magic = JOURNAL_MAGIC;
+	Record.Version = JOURNAL_VERSION;
+	Record.Sequence = JournalSequence + 1;
+	Record.Settings = gSettings;
+	Record.Extended = gExtendedSettings;
+	Record.Crc = GetRecordCrc(&Record);
+
+	if (JournalLast) {
+		SFLASH_Read(&Check, JournalLast, sizeof(Check));
+		if (memcmp(&Check.Settings, &Record.Settings, sizeof(Record.Settings)) == 0 && memcmp(&Check.Extended, &Record.Extended, sizeof(Record.Extended)) == 0) {
+			return true;
+		}
+	}
+
+	SFLASH_Lock();
+
+	// Moving on to the next sector erases it, the newest record stays in the
+	// current one until the new record is complete.
+	for (Tries = 0; Tries < JOURNAL_SECTORS * JOURNAL_SLOTS; Tries++) {
+		if (JournalSlot >= JOURNAL_SLOTS) {
+			JournalSector = (JournalSector + 1) % JOURNAL_SECTORS;
+			JournalSlot = 0;
+			SFLASH_Erase((JOURNAL_ADDRESS >> 12) + JournalSector);
+		}
+		Address = GetSlotAddress(JournalSector, JournalSlot++);
+		SFLASH_Read(&Check, Address, sizeof(Check));
+		if (IsBlank(&Check, sizeof(Check))) {
+			break;
+		}
+		Address = 0;
+	}
+
+	if (Address) {
+		SFLASH_Write(&Record.Version, Address + 1, sizeof(Record) - 1);
+		SFLASH_Write(&Record.Magic, Address, 1);
+		SFLASH_Read(&Check, Address, sizeof(Check));
+		if (memcmp(&Check, &Record, sizeof(Record)) != 0) {
+			Address = 0;
+		}
+	}
+
+	SFLASH_Unlock();
+
+	if (Address == 0) {
+		return false;
+	}
+	JournalSequence = Record.Sequence;
+	JournalLast = Address;
+
+	return true;
+}
+
+void JOURNAL_Erase(void)
+{
+	uint8_t i;
+
+	SFLASH_Lock();
+	for (i = 0; i < JOURNAL_SECTORS; i++) {
+		SFLASH_Erase((JOURNAL_ADDRESS >> 12) + i);
+	}
+	SFLASH_Unlock();
+	JournalSector = 0;
+	JournalSlot = JOURNAL_SLOTS;
+	JournalLast = 0;
+}
+
+bool JOURNAL_IsUsed(void)
+{
+	return JournalLast != 0;
+}
@@ -0,0 +1,30 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_JOURNAL_H
+#define RADIO_JOURNAL_H
+
+#include <stdbool.h>
+
+// Loads the newest record over gSettings and gExtendedSettings, if any.
+void JOURNAL_Load(void);
+// False when no slot could be programmed, the caller falls back to the fixed locations.
+bool JOURNAL_Save(void);
+void JOURNAL_Erase(void);
+bool JOURNAL_IsUsed(void);
+
+#endif
+
@@ -0,0 +1,70 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "radio/lockout.h"
+
+// Sorted, so a scanner hop only costs a binary search
+static uint32_t Lockout[LOCKOUT_MAX];
+static uint8_t LockoutCount;
+
+static uint8_t FindIndex(uint32_t Frequency)
+{
+	uint8_t Low = 0;
+	uint8_t High = LockoutCount;
+
+	while (Low < High) {
+		const uint8_t Mid = (Low + High) / 2;
+
+		if (Lockout[Mid] < Frequency) {
+			Low = Mid + 1;
+		} else {
+			High = Mid;
+		}
+	}
+
+	return Low;
+}
+
+bool LOCKOUT_Add(uint32_t Frequency)
+{
+	const uint8_t i = FindIndex(Frequency);
+
+	if (i < LockoutCount && Lockout[i] == Frequency) {
+		return true;
+	}
+	if (LockoutCount == LOCKOUT_MAX) {
+		return false;
+	}
+	memmove(&Lockout[i + 1], &Lockout[i], (LockoutCount - i) * sizeof(Lockout[0]));
+	Lockout[i] = Frequency;
+	LockoutCount++;
+
+	return true;
+}
+
+bool LOCKOUT_Contains(uint32_t Frequency)
+{
+	const uint8_t i = FindIndex(Frequency);
+
+	return i < LockoutCount && Lockout[i] == Frequency;
+}
+
+void LOCKOUT_Clear(void)
+{
+	LockoutCount = 0;
+}
+
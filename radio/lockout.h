@@ -0,0 +1,31 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_LOCKOUT_H
+#define RADIO_LOCKOUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Frequencies the scanner skips until power off
+#define LOCKOUT_MAX 16
+
+bool LOCKOUT_Add(uint32_t Frequency);
+bool LOCKOUT_Contains(uint32_t Frequency);
+void LOCKOUT_Clear(void);
+
+#endif
+
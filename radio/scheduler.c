@@ -47,6 +47,7 @@ uint16_t gBatteryTimer;
 uint16_t gSaveModeTimer;
 uint32_t gIdleTimer;
 uint16_t gDetectorTimer;
+uint16_t gSettingsSaveTimer;
 
 static void SetTask(uint16_t Task)
 {
@@ -132,6 +133,9 @@ void HandlerTMR1_BRK_OVF_TRG_HALL(void)
 	if (gDetectorTimer) {
 		gDetectorTimer--;
 	}
+	if (gSettingsSaveTimer) {
+		gSettingsSaveTimer--;
+	}
 	if (UART_Timer) {
 		UART_Timer--;
 	} else {
@@ -150,7 +154,7 @@ void HandlerTMR1_BRK_OVF_TRG_HALL(void)
 	if (gBlinkGreen) {
 		gGreenLedTimer++;
 	}
-	SetTask(TASK_CHECK_SIDE_KEYS | TASK_CHECK_KEY_PAD | TASK_CHECK_PTT | TASK_CHECK_INCOMING);
+	SetTask(TASK_CHECK_SIDE_KEYS | TASK_CHECK_KEY_PAD | TASK_CHECK_PTT | TASK_CHECK_INCOMING | TASK_FREQUENCY_DETECT);
 	if ((SCHEDULER_Counter & 1) == 0) {
 	//	SetTask(TASK_CHECK_RSSI | TASK_CHECK_INCOMING);
 		SetTask(TASK_CHECK_RSSI);
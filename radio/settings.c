@@ -14,6 +14,7 @@
  *     limitations under the License.
  */
 
+#include <string.h>
 #include "app/radio.h"
 #include "driver/bk4819.h"
 #include "driver/delay.h"
@@ -21,13 +22,19 @@
 #include "driver/pins.h"
 #include "driver/serial-flash.h"
 #include "helper/dtmf.h"
+#include "helper/helper.h"
 #include "misc.h"
 #include "radio/hardware.h"
+#ifdef ENABLE_SETTINGS_JOURNAL
+	#include "radio/journal.h"
+#endif
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/keyaction.h"
 #include "task/scanner.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
+#include "ui/vfo.h"
 
 Calibration_t gCalibration;
 char gDeviceName[16];
@@ -36,6 +43,45 @@ char WelcomeString[32];
 uint32_t gFrequencyStep = 25;
 gExtendedSettings_t gExtendedSettings;
 
+// Saves are coalesced until nothing has changed for this long
+#define SETTINGS_SAVE_DELAY 1000
+
+static bool bSettingsDirty;
+
+// Only rewrites the sector when the bytes in flash differ
+static void UpdateIfChanged(const void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint8_t Chunk[16];
+	uint16_t Length;
+	uint16_t i;
+
+	for (i = 0; i < Size; i += Length) {
+		Length = Size - i;
+		if (Length > sizeof(Chunk)) {
+			Length = sizeof(Chunk);
+		}
+		SFLASH_Read(Chunk, Address + i, Length);
+		if (memcmp(Chunk, pBytes + i, Length) != 0) {
+			SFLASH_Update(pBuffer, Address, Size);
+			return;
+		}
+	}
+}
+
+#ifdef ENABLE_SETTINGS_JOURNAL
+// The programming software only knows the fixed locations, so bring them up
+// to date and start the journal over.
+void SETTINGS_FlushJournal(void)
+{
+	if (JOURNAL_IsUsed()) {
+		UpdateIfChanged(&gSettings, 0x3C1030, sizeof(gSettings));
+		UpdateIfChanged(&gExtendedSettings, 0x3D5000, sizeof(gExtendedSettings));
+		JOURNAL_Erase();
+	}
+}
+#endif
+
 static void RestoreCalibration(void)
 {
 	SFLASH_Read(gFlashBuffer, 0x3C0000, 0x1000);
@@ -107,6 +153,9 @@ void SETTINGS_LoadSettings(void)
 	SFLASH_Read(&gDTMF_Wake, 0x3C9E50, sizeof(gDTMF_Wake));
 	// Extended Settings bits are all 1 at first read as the flash is full of 0xFF
 	SFLASH_Read(&gExtendedSettings, 0x3D5000, sizeof(gExtendedSettings));
+#ifdef ENABLE_SETTINGS_JOURNAL
+	JOURNAL_Load();
+#endif
 
 	if (gExtendedSettings.KeyShortcut[0] == 0xFF) {
 		SetDefaultKeyShortcuts(false); //
@@ -119,6 +168,9 @@ void SETTINGS_LoadSettings(void)
 	if (gExtendedSettings.MicGainLevel > 31) {
 		gExtendedSettings.MicGainLevel = 19;
 	}
+	if (gExtendedSettings.PriorityScan > 3) {
+		gExtendedSettings.PriorityScan = 0;
+	}
 	BK4819_SetMicSensitivityTuning();
 
 	gSettings.bEnableDisplay = 1;
@@ -138,8 +190,31 @@ void SETTINGS_LoadSettings(void)
 
 void SETTINGS_SaveGlobals(void)
 {
-	SFLASH_Update(&gSettings, 0x3C1030, sizeof(gSettings));
-	SFLASH_Update(&gExtendedSettings, 0x3D5000, sizeof(gExtendedSettings));
+	gSettingsSaveTimer = SETTINGS_SAVE_DELAY;
+	bSettingsDirty = true;
+}
+
+// Writes a pending save now. Task_SaveSettings calls it once the timer runs
+// out, reboots call it directly.
+void SETTINGS_FlushGlobals(void)
+{
+	if (!bSettingsDirty) {
+		return;
+	}
+	bSettingsDirty = false;
+#ifdef ENABLE_SETTINGS_JOURNAL
+	if (JOURNAL_Save()) {
+		return;
+	}
+#endif
+	UpdateIfChanged(&gSettings, 0x3C1030, sizeof(gSettings));
+	UpdateIfChanged(&gExtendedSettings, 0x3D5000, sizeof(gExtendedSettings));
+#ifdef ENABLE_SETTINGS_JOURNAL
+	// An older record would otherwise win at the next boot
+	if (JOURNAL_IsUsed()) {
+		JOURNAL_Erase();
+	}
+#endif
 }
 
 void SETTINGS_SaveState(void)
@@ -147,6 +222,12 @@ void SETTINGS_SaveState(void)
 	gScannerMode = false;
 	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
 	SCANNER_Countdown = 0;
+#ifdef ENABLE_FAST_SCAN_TUNE
+	RADIO_EndScanTune();
+#endif
+	if (CHANNELS_CompleteScanChannel() && gScreenMode == SCREEN_MAIN) {
+		UI_DrawVfo(gSettings.CurrentVfo);
+	}
 	if (gSettings.WorkMode) {
 		SETTINGS_SaveGlobals();
 	} else {
@@ -17,6 +17,7 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 enum {
@@ -171,7 +172,9 @@ typedef struct __attribute__((packed)) {
 	uint8_t ScanAll: 1;
 	uint8_t MicGainLevel: 6;
 	uint8_t Undefined: 1;	// free for use
-	// 0x10...
+	// 0x10
+	uint8_t PriorityScan;	// Off=0, 1s=1, 2s=2, 5s=3
+	// 0x11...
 } gExtendedSettings_t;
 
 extern Calibration_t gCalibration;
@@ -185,11 +188,15 @@ void SETTINGS_BackupCalibration(void);
 void SETTINGS_LoadCalibration(void);
 void SETTINGS_LoadSettings(void);
 void SETTINGS_SaveGlobals(void);
+void SETTINGS_FlushGlobals(void);
 void SETTINGS_SaveState(void);
 void SETTINGS_SaveDTMF(void);
 void SETTINGS_FactoryReset(void);
 void SETTINGS_SaveDeviceName(void);
 void SETTINGS_BackupSettings(void);
+#ifdef ENABLE_SETTINGS_JOURNAL
+void SETTINGS_FlushJournal(void);
+#endif
 
 #endif
 
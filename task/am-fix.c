@@ -300,7 +300,7 @@ void AM_fix_reset(const int vfo)
 //
 void Task_AM_fix()
 {
-	if(gAmFixCountdown != 0 || !gExtendedSettings.AmFixEnabled) {
+	if(gAmFixCountdown != 0 || !gExtendedSettings.AmFixEnabled || gFrequencyDetectMode) {
 		//if(!bFgcSet) {
 		//	BK4819_ForceFGCMode(1);
 		//	bFgcSet = true;
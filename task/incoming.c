@@ -52,6 +52,9 @@ void Task_CheckIncoming(void)
 			if (gRxLinkCounter++ > 5) {
 				gRxLinkCounter = 0;
 				gSaveModeTimer = 300;
+#ifdef ENABLE_FAST_SCAN_TUNE
+				RADIO_CompleteScanTune();
+#endif
 				if (gMainVfo->BCL == BUSY_LOCK_CARRIER && !gFrequencyDetectMode) {
 					PTT_SetLock(PTT_LOCK_INCOMING);
 				}
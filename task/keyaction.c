@@ -35,6 +35,7 @@
 #include "helper/inputbox.h"
 #include "misc.h"
 #include "radio/detector.h"
+#include "radio/lockout.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/alarm.h"
@@ -98,6 +99,13 @@ void KeypressAction(uint8_t Action) {
 	if (gScannerMode) {
 		if (Action == ACTION_SCAN && gSettings.WorkMode) {
 			Next_ScanList();
+		} else if (Action == ACTION_LOCKOUT) {
+			if (LOCKOUT_Add(gVfoState[gSettings.CurrentVfo].RX.Frequency)) {
+				gForceScan = true;
+				BEEP_Play(740, 2, 100);
+			} else {
+				BEEP_Play(440, 4, 80);
+			}
 		} else {
 			SETTINGS_SaveState();
 			BEEP_Play(440, 4, 80);
@@ -133,7 +141,6 @@ void KeypressAction(uint8_t Action) {
 			case ACTION_FREQUENCY_DETECT:
 				if (!gSettings.bFLock) {
 					gInputBoxWriteIndex = 0;
-					KEY_LongPressed = false;
 					RADIO_FrequencyDetect();
 				}
 				break;
@@ -217,6 +224,11 @@ void KeypressAction(uint8_t Action) {
 				RADIO_CancelMode();
 				gManualScanDirection = gSettings.ScanDirection;
 				gScannerMode ^= 1;
+#ifdef ENABLE_FAST_SCAN_TUNE
+				if (!gScannerMode) {
+					RADIO_EndScanTune();
+				}
+#endif
 				bBeep740 = gScannerMode;
 				SCANNER_Countdown = 65; ////
 				UI_DrawScan();  
@@ -437,6 +449,12 @@ void KeypressAction(uint8_t Action) {
 				SETTINGS_SaveGlobals();
 				UI_DrawDialogText(DIALOG_TX_PRIORITY, gSettings.TxPriority);
 				break;
+
+			// Locks out the frequency being scanned, outside of a scan it clears the list
+			case ACTION_LOCKOUT:
+				LOCKOUT_Clear();
+				BEEP_Play(440, 4, 80);
+				break;
 		}
 	}
 }
\ No newline at end of file
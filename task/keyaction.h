@@ -53,6 +53,7 @@ enum {
 	ACTION_BAND_WIDTH,
 	ACTION_TX_CTCSS_DCS,
 	ACTION_TX_PRIORITY,
+	ACTION_LOCKOUT,
 	ACTIONS_COUNT,	// used to count the number of actions, keep this last
 };
 
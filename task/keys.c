@@ -26,6 +26,7 @@
 #include "helper/helper.h"
 #include "helper/inputbox.h"
 #include "misc.h"
+#include "radio/detector.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/alarm.h"
@@ -287,6 +288,9 @@ static void HandlerShort(KEY_t Key)
 	case SCREEN_SETTING:
 		MENU_SettingKeyHandler(Key);
 		break;
+	case SCREEN_FREQ_DETECT:
+		DETECTOR_KeyHandler(Key);
+		break;
 	default:
 		break;
 	}
@@ -300,6 +304,10 @@ static void HandlerLong(KEY_t Key)
 		return;
 	}
 
+	if (gFrequencyDetectMode) {
+		return;
+	}
+
 	bBeep740 = true;
 	if (!gReceptionMode && (gFM_Mode == FM_MODE_OFF || Key == KEY_0 || Key == KEY_HASH || Key == KEY_UP || Key == KEY_DOWN)) {
 		SCREEN_TurnOn();
@@ -38,33 +38,38 @@ enum {
 static uint8_t GetToneStatus(uint8_t CodeType, bool bMuteEnabled)
 {
 	uint16_t Value;
-	
-	Value = BK4819_ReadRegister(0x0C);
+
+	BK4819_PollEvents();
+	while (BK4819_GetEvent(&Value)) {
+		// Check Interrupt Request
+		if (Value & BK4819_EVENT_IRQ && gRadioMode == RADIO_MODE_RX
+#ifdef ENABLE_NOAA
+			&& !gNoaaMode
+#endif
+			) {
+			DATA_ReceiverCheck();
+		}
+	}
+	Value = gBK4819_Status;
 
 #ifdef ENABLE_NOAA
 	if (gNoaaMode) {
 		// Checks CTC1
-		return (Value & 0x0400U) ? STATUS_GOT_TONE : STATUS_NO_TONE;
+		return (Value & BK4819_EVENT_CTC1) ? STATUS_GOT_TONE : STATUS_NO_TONE;
 	}
 #endif
 
-	// Check Interrupt Request
-	if (Value & 0x0001U && gRadioMode == RADIO_MODE_RX) {
-		DATA_ReceiverCheck();
-		Value = BK4819_ReadRegister(0x0C);
-	}
-
 	if (gMonitorMode) {
 		return STATUS_GOT_TONE;
 	}
 
 	// Check CTC2(55hz)
-	if (Value & 0x0800U) {
+	if (Value & BK4819_EVENT_CTC2) {
 		return STATUS_TAIL_TONE;
 	}
 
 	// Check CTC1
-	if (Value & 0x0400U) {
+	if (Value & BK4819_EVENT_CTC1) {
 		if (CodeType == CODE_TYPE_CTCSS) {
 			return STATUS_GOT_TONE;
 		}
@@ -74,12 +79,12 @@ static uint8_t GetToneStatus(uint8_t CodeType, bool bMuteEnabled)
 	}
 
 	// Check DCS N
-	if (Value & 0x4000U && (CodeType == CODE_TYPE_DCS_N || bMuteEnabled)) {
+	if (Value & BK4819_EVENT_DCS_N && (CodeType == CODE_TYPE_DCS_N || bMuteEnabled)) {
 		return STATUS_GOT_TONE;
 	}
 
 	// Check DCS I
-	if (Value & 0x8000U && CodeType == CODE_TYPE_DCS_I) {
+	if (Value & BK4819_EVENT_DCS_I && CodeType == CODE_TYPE_DCS_I) {
 		return STATUS_GOT_TONE;
 	}
 
@@ -16,18 +16,205 @@
 
 #include "app/radio.h"
 #include "bsp/gpio.h"
+#include "driver/bk4819.h"
+#include "driver/delay.h"
 #include "driver/key.h"
 #include "driver/pins.h"
+#include "driver/uart.h"
 #include "misc.h"
 #include "radio/channels.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/scanner.h"
 #include "ui/helper.h"
+#include "ui/vfo.h"
+
+// A hop is followed by a short probe: channels that are clearly below
+// squelch on RSSI, noise and glitch are left at once, borderline ones get a
+// longer listen.
+#define SCAN_PROBE_MS			8
+#define SCAN_DWELL_MS			65
+#define SCAN_EXTENDED_DWELL_MS	200
+#define SCAN_RSSI_MARGIN		12	// 6 dB
+#define SCAN_NOISE_MARGIN		8
+#define SCAN_GLITCH_MARGIN		8
+
+// Priority watch: the preset channels are checked on a timer by moving only
+// the PLL there and back, and taken over when one is above the squelch.
+#define PRIORITY_SETTLE_MS		3
+#define PRIORITY_UNLOADED		0xFF
+
+enum {
+	PROBE_CLOSED,
+	PROBE_BORDERLINE,
+	PROBE_OPEN,
+};
 
 uint16_t SCANNER_Countdown;
+uint16_t SCANNER_HopRate;
+
+static const uint16_t PriorityIntervals[4] = { 0, 1000, 2000, 5000 };
+
+static bool bProbePending;
+static uint16_t HopCount;
+static uint32_t HopRateStart;
+static uint16_t PriorityChannel[4];
+static uint32_t PriorityFrequency[4];
+static uint8_t PriorityCount = PRIORITY_UNLOADED;
+static uint32_t PriorityLast;
+
+static uint8_t ProbeChannel(void)
+{
+	const int16_t Rssi = BK4819_GetRSSI();
+	const int16_t Noise = BK4819_GetNoise();
+	const int16_t Glitch = BK4819_GetGlitch();
+
+	if (Rssi < gSquelchOpenRssi - SCAN_RSSI_MARGIN && Noise > gSquelchOpenNoise + SCAN_NOISE_MARGIN && Glitch > gSquelchOpenGlitch + SCAN_GLITCH_MARGIN) {
+		return PROBE_CLOSED;
+	}
+	if (Rssi >= gSquelchOpenRssi && Noise <= gSquelchOpenNoise && Glitch <= gSquelchOpenGlitch) {
+		return PROBE_OPEN;
+	}
+
+	return PROBE_BORDERLINE;
+}
+
+static void UpdateHopRate(void)
+{
+	const uint32_t Elapsed = gTimeSinceBoot - HopRateStart;
+
+	HopCount++;
+	if (Elapsed >= 1000) {
+		SCANNER_HopRate = (HopCount * 1000U) / Elapsed;
+		HopCount = 0;
+		HopRateStart = gTimeSinceBoot;
+#ifdef UART_DEBUG
+		UART_printf("Scan: %u hops/s flash loads: %u\r\n", (unsigned int)SCANNER_HopRate, (unsigned int)gScanCacheMisses);
+		gScanCacheMisses = 0;
+		RADIO_PrintTuneStats();
+#endif
+		UI_DrawScan();
+	}
+}
+
+// Usable preset channels, read once per scan as they cannot change meanwhile
+static void LoadPriorityChannels(void)
+{
+	uint8_t Slot;
+	uint8_t i;
+
+	PriorityCount = 0;
+	PriorityLast = gTimeSinceBoot;
+	for (Slot = 0; Slot < 4; Slot++) {
+		const uint16_t Channel = gSettings.PresetChannels[Slot];
+		const uint32_t Frequency = CHANNELS_GetRxFrequency(Channel);
+
+		for (i = 0; i < PriorityCount && PriorityChannel[i] != Channel; i++) {
+		}
+		if (Frequency == 0 || i < PriorityCount) {
+			continue;
+		}
+		PriorityChannel[PriorityCount] = Channel;
+		PriorityFrequency[PriorityCount] = Frequency;
+		PriorityCount++;
+	}
+}
+
+// During a reception the audio is muted while the PLL is away and until the
+// squelch has settled back on the received channel.
+static bool ProbePriority(uint32_t Frequency)
+{
+	const bool bUseUhfFilter = gUseUhfFilter;
+	const bool bReceiving = gRadioMode == RADIO_MODE_RX;
+	uint16_t AF = 0;
+	bool bFilterChanged;
+	uint16_t Rssi;
+
+	if (bReceiving) {
+		AF = BK4819_ReadRegister(0x47);
+		BK4819_SetAF(BK4819_AF_MUTE);
+	}
+	BK4819_SetFrequency(Frequency);
+	bFilterChanged = gUseUhfFilter != bUseUhfFilter;
+	if (bFilterChanged) {
+		BK4819_EnableFilter(true);
+	}
+	BK4819_RetuneRX();
+	DELAY_WaitMS(PRIORITY_SETTLE_MS);
+	Rssi = BK4819_GetRSSI();
+
+	BK4819_SetFrequency(gVfoInfo[gCurrentVfo].Frequency);
+	if (bFilterChanged) {
+		BK4819_EnableFilter(true);
+	}
+	BK4819_RetuneRX();
+	if (bReceiving) {
+		DELAY_WaitMS(PRIORITY_SETTLE_MS);
+		BK4819_WriteRegister(0x47, AF);
+	}
+
+	return Rssi >= gSquelchOpenRssi;
+}
+
+static void CheckPriority(void)
+{
+	uint8_t i;
+
+	if (!gScannerMode) {
+		PriorityCount = PRIORITY_UNLOADED;
+		return;
+	}
+	// An open squelch would take every priority channel over
+	if (PriorityCount == PRIORITY_UNLOADED || PriorityCount == 0 || !gSettings.WorkMode || gSettings.Squelch == 0 || gExtendedSettings.PriorityScan == 0) {
+		return;
+	}
+	// The hop probe reads the channel the scanner just moved to
+	if (bProbePending || gRadioMode == RADIO_MODE_TX) {
+		return;
+	}
+	if (gTimeSinceBoot - PriorityLast < PriorityIntervals[gExtendedSettings.PriorityScan]) {
+		return;
+	}
+	PriorityLast = gTimeSinceBoot;
+
+	for (i = 0; i < PriorityCount; i++) {
+		if (PriorityChannel[i] == gSettings.VfoChNo[gSettings.CurrentVfo]) {
+			continue;
+		}
+		if (ProbePriority(PriorityFrequency[i])) {
+			if (gRadioMode == RADIO_MODE_RX) {
+				RADIO_EndRX();
+			}
+			gSettings.VfoChNo[gSettings.CurrentVfo] = PriorityChannel[i];
+			CHANNELS_LoadChannel(PriorityChannel[i], gSettings.CurrentVfo);
+			RADIO_Tune(gSettings.CurrentVfo);
+			UI_DrawVfo(gSettings.CurrentVfo);
+			SCANNER_Countdown = SCAN_DWELL_MS;
+			return;
+		}
+	}
+}
 
 void Task_Scanner(void) {
+	CheckPriority();
+	if (bProbePending && SCANNER_Countdown == 0) {
+		bProbePending = false;
+		if (!gScannerMode || gRadioMode != RADIO_MODE_QUIET) {
+			SCANNER_Countdown = SCAN_DWELL_MS - SCAN_PROBE_MS;
+		} else {
+			switch (ProbeChannel()) {
+			case PROBE_CLOSED:
+				gForceScan = true;
+				break;
+			case PROBE_BORDERLINE:
+				SCANNER_Countdown = SCAN_EXTENDED_DWELL_MS - SCAN_PROBE_MS;
+				break;
+			default:
+				SCANNER_Countdown = SCAN_DWELL_MS - SCAN_PROBE_MS;
+				break;
+			}
+		}
+	}
 	if ((gRadioMode < (gExtendedSettings.ScanResume == 2 ? RADIO_MODE_TX : RADIO_MODE_RX) 	// Allows Task_Scanner in RX mode if ScanResume is set to Time Operated
 			&& gScannerMode
 			&& SCANNER_Countdown == 0
@@ -47,7 +234,12 @@ void Task_Scanner(void) {
 			CHANNELS_NextChannelVfo(gManualScanDirection ? KEY_DOWN : KEY_UP);
 			RADIO_Tune(gSettings.CurrentVfo);
 		}
-		SCANNER_Countdown = 65; ////
+		SCANNER_Countdown = SCAN_PROBE_MS;
+		bProbePending = true;
+		UpdateHopRate();
+		if (PriorityCount == PRIORITY_UNLOADED) {
+			LoadPriorityChannels();
+		}
 		if (gExtendedSettings.ScanBlink) {
 			gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_GREEN);
 		}
@@ -63,6 +255,7 @@ void Next_ScanList(void) {
 			gExtendedSettings.ScanAll = 1;
 		}
 	}
+	CHANNELS_InvalidateScanCache();
 	UI_DrawScan();
 }
 
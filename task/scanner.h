@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 extern uint16_t SCANNER_Countdown;
+extern uint16_t SCANNER_HopRate;
 
 void Task_Scanner(void);
 void Next_ScanList(void);
@@ -0,0 +1,222 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Runs the settings journal on a simulated NOR flash: programming only clears
+// bits, erases set a whole sector back to 0xFF and a power loss can stop a
+// write after any byte. Built with the journal source so a reboot can reset
+// its state.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "radio/journal.c"
+
+#define FLASH_BASE	JOURNAL_ADDRESS
+#define FLASH_SIZE	(JOURNAL_SECTORS * 0x1000U)
+
+gSettings_t gSettings;
+gExtendedSettings_t gExtendedSettings;
+
+static uint8_t Flash[FLASH_SIZE];
+static uint32_t Erases;
+// Bytes programmed before the power goes, -1 for no power loss
+static int32_t WriteBudget = -1;
+static int Failures;
+
+// What the fixed locations hold
+#define FALLBACK	0xFFFF
+
+static uint8_t *GetFlash(uint32_t Address, uint16_t Size)
+{
+	if (Address < FLASH_BASE || Address + Size > FLASH_BASE + FLASH_SIZE) {
+		printf("journal: access outside the journal at 0x%06X\n", Address);
+		exit(EXIT_FAILURE);
+	}
+
+	return Flash + (Address - FLASH_BASE);
+}
+
+void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	memcpy(pBuffer, GetFlash(Address, Size), Size);
+}
+
+void SFLASH_Erase(uint32_t Page)
+{
+	memset(GetFlash(Page << 12, 0x1000), 0xFF, 0x1000);
+	Erases++;
+}
+
+void SFLASH_Write(const void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint8_t *pFlash = GetFlash(Address, Size);
+
+	while (Size-- && WriteBudget != 0) {
+		*pFlash++ &= *pBytes++;
+		if (WriteBudget > 0) {
+			WriteBudget--;
+		}
+	}
+}
+
+void SFLASH_Lock(void)
+{
+}
+
+void SFLASH_Unlock(void)
+{
+}
+
+uint16_t CRC16_Calculate(const void *pBuffer, uint16_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint16_t Crc = 0xFFFF;
+	uint8_t i;
+
+	while (Size--) {
+		Crc ^= *pBytes++ << 8;
+		for (i = 0; i < 8; i++) {
+			Crc = (Crc & 0x8000) ? (Crc << 1) ^ 0x1021 : Crc << 1;
+		}
+	}
+
+	return Crc;
+}
+
+static void Expect(bool bCondition, const char *pMessage, uint32_t Value)
+{
+	if (!bCondition) {
+		printf("journal: FAIL %s (%u)\n", pMessage, Value);
+		Failures++;
+	}
+}
+
+// Power cycle: RAM is gone, the fixed settings are reloaded.
+static void Reboot(void)
+{
+	JournalSector = 0;
+	JournalSlot = JOURNAL_SLOTS;
+	JournalSequence = 0;
+	JournalLast = 0;
+	memset(&gSettings, 0, sizeof(gSettings));
+	memset(&gExtendedSettings, 0xFF, sizeof(gExtendedSettings));
+	gSettings.BorderColor = FALLBACK;
+	JOURNAL_Load();
+}
+
+static bool Save(uint16_t Value)
+{
+	gSettings.BorderColor = Value;
+	gExtendedSettings.PriorityScan = Value & 3;
+
+	return JOURNAL_Save();
+}
+
+// Saves until the current sector has no free slot left.
+static void FillSector(uint16_t *pValue)
+{
+	uint8_t i;
+
+	for (i = 0; i < JOURNAL_SLOTS && JournalSlot != JOURNAL_SLOTS; i++) {
+		Save(++*pValue);
+		Reboot();
+	}
+	Expect(JournalSlot == JOURNAL_SLOTS, "sector filled", *pValue);
+}
+
+int main(void)
+{
+	uint16_t Value;
+	uint32_t Last;
+	int32_t Budget;
+
+	memset(Flash, 0xFF, sizeof(Flash));
+
+	Reboot();
+	Expect(!JOURNAL_IsUsed() && gSettings.BorderColor == FALLBACK, "blank journal keeps the fixed settings", 0);
+
+	// 1000 saves, every one survives a reboot
+	Erases = 0;
+	for (Value = 1; Value <= 1000; Value++) {
+		Expect(Save(Value), "save", Value);
+		Reboot();
+		Expect(gSettings.BorderColor == Value && gExtendedSettings.PriorityScan == (Value & 3), "newest record loaded", Value);
+	}
+	printf("journal: %u erases per 1000 saves\n", Erases);
+	Expect(Erases <= (1000 / JOURNAL_SLOTS) + 1, "erases per 1000 saves", Erases);
+
+	// An unchanged save programs nothing
+	Value = 1000;
+	Last = JournalLast;
+	Expect(Save(Value) && JournalLast == Last, "unchanged save", JournalLast);
+
+	// Power lost after every byte count of a record, first inside a sector, then
+	// on the first slot of the next one, right after its erase
+	for (Budget = 0; Budget < (int32_t)sizeof(JournalRecord_t); Budget++) {
+		if (JournalSlot == JOURNAL_SLOTS) {
+			Save(++Value);
+			Reboot();
+		}
+		WriteBudget = Budget;
+		Save(Value + 1);
+		WriteBudget = -1;
+		Reboot();
+		Expect(gSettings.BorderColor == Value, "torn record ignored", Budget);
+		Expect(Save(++Value), "save after a torn record", Budget);
+		Reboot();
+		Expect(gSettings.BorderColor == Value, "record after a torn one loaded", Budget);
+	}
+	FillSector(&Value);
+	for (Budget = 0; Budget < (int32_t)sizeof(JournalRecord_t); Budget++) {
+		WriteBudget = Budget;
+		Save(Value + 1);
+		WriteBudget = -1;
+		Reboot();
+		Expect(gSettings.BorderColor == Value, "torn record in a new sector ignored", Budget);
+		FillSector(&Value);
+	}
+
+	// A bit lost in the newest record: its CRC rejects it, the previous one wins
+	Save(++Value);
+	Save(++Value);
+	((JournalRecord_t *)GetFlash(JournalLast, sizeof(JournalRecord_t)))->Settings.BorderColor &= Value - 1;
+	Reboot();
+	Expect(gSettings.BorderColor == Value - 1, "corrupt record rejected", Value);
+
+	// A bad magic is skipped the same way
+	Save(++Value);
+	GetFlash(JournalLast, 1)[0] = 0;
+	Reboot();
+	Expect(gSettings.BorderColor == Value - 2, "bad magic rejected", Value);
+
+	// So is a record of another version
+	Save(++Value);
+	GetFlash(JournalLast, 2)[1] = JOURNAL_VERSION - 1;
+	Reboot();
+	Expect(gSettings.BorderColor == Value - 3, "other version rejected", Value);
+
+	// Erasing falls back to the fixed locations
+	JOURNAL_Erase();
+	Reboot();
+	Expect(!JOURNAL_IsUsed() && gSettings.BorderColor == FALLBACK, "erased journal", 0);
+
+	if (Failures) {
+		return EXIT_FAILURE;
+	}
+	printf("journal: ok\n");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Decodes the ST7735S byte stream of the host stub backend into a frame
+// and checks what the drawing helpers put on the panel.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "driver/st7735s.h"
+#include "ui/gfx.h"
+
+#define PANEL_COLUMNS	128
+#define PANEL_ROWS	160
+
+static uint16_t Frame[PANEL_ROWS][PANEL_COLUMNS];
+static uint8_t Command;
+static uint8_t Args[4];
+static uint8_t ArgCount;
+static uint16_t Column0, Column1, Row0, Row1;
+static uint16_t Column, Row;
+static uint8_t PixelHigh;
+static uint32_t Bytes;
+static int Failures;
+
+void DELAY_WaitMS(uint16_t Delay)
+{
+}
+
+void ST7735S_StubWrite(bool bCommand, uint8_t Data)
+{
+	Bytes++;
+	if (bCommand) {
+		Command = Data;
+		ArgCount = 0;
+		if (Command == ST7735S_CMD_RAMWR) {
+			Column = Column0;
+			Row = Row0;
+		}
+		return;
+	}
+	if (Command == ST7735S_CMD_CASET || Command == ST7735S_CMD_RASET) {
+		if (ArgCount < 4) {
+			Args[ArgCount++] = Data;
+		}
+		if (ArgCount == 4 && Command == ST7735S_CMD_CASET) {
+			Column0 = (Args[0] << 8) | Args[1];
+			Column1 = (Args[2] << 8) | Args[3];
+		} else if (ArgCount == 4) {
+			Row0 = (Args[0] << 8) | Args[1];
+			Row1 = (Args[2] << 8) | Args[3];
+		}
+		return;
+	}
+	if (Command != ST7735S_CMD_RAMWR) {
+		return;
+	}
+	if (ArgCount++ % 2 == 0) {
+		PixelHigh = Data;
+		return;
+	}
+	if (Row <= Row1 && Row < PANEL_ROWS && Column < PANEL_COLUMNS) {
+		Frame[Row][Column] = (PixelHigh << 8) | Data;
+	}
+	if (Column++ == Column1) {
+		Column = Column0;
+		Row++;
+	}
+}
+
+static void Expect(bool bCondition, const char *pMessage)
+{
+	if (!bCondition) {
+		printf("lcd: FAIL %s\n", pMessage);
+		Failures++;
+	}
+}
+
+static uint32_t CountPixels(uint16_t Color)
+{
+	uint32_t Count = 0;
+	uint16_t X, Y;
+
+	for (X = 0; X < PANEL_ROWS; X++) {
+		for (Y = 0; Y < PANEL_COLUMNS; Y++) {
+			Count += Frame[X][Y] == Color;
+		}
+	}
+
+	return Count;
+}
+
+int main(void)
+{
+	const uint16_t Red = COLOR_RGB(31, 0, 0);
+	const uint16_t Blue = COLOR_RGB(0, 0, 31);
+
+	DISPLAY_FillColor(Blue);
+	Expect(CountPixels(Blue) == PANEL_ROWS * PANEL_COLUMNS, "full screen fill");
+	Expect(Bytes == 11 + (PANEL_ROWS * PANEL_COLUMNS * 2), "full screen fill bus bytes");
+
+	Bytes = 0;
+	DISPLAY_DrawRectangle0(10, 20, 30, 5, Red);
+	Expect(CountPixels(Red) == 30 * 5, "rectangle size");
+	Expect(Frame[10][20] == Red && Frame[39][24] == Red, "rectangle corners");
+	Expect(Frame[9][20] == Blue && Frame[40][24] == Blue && Frame[10][25] == Blue, "rectangle bounds");
+	Expect(Bytes == 11 + (30 * 5 * 2), "rectangle bus bytes");
+
+	ST7735S_SetPixel(159, 127, Red);
+	Expect(Frame[159][127] == Red, "pixel in the far corner");
+
+	ST7735S_SetWindow(0, 1, 0, 1);
+	ST7735S_BeginPixels();
+	ST7735S_PushPixel(1);
+	ST7735S_PushPixel(2);
+	ST7735S_PushPixels(3, 2);
+	ST7735S_EndPixels();
+	Expect(Frame[0][0] == 1 && Frame[0][1] == 2 && Frame[1][0] == 3 && Frame[1][1] == 3, "pixel order in a window");
+
+	Bytes = 0;
+	ST7735S_SetWindow(50, 51, 60, 60);
+	ST7735S_MoveWindowX(70, 71);
+	ST7735S_BeginPixels();
+	ST7735S_PushPixels(Red, 2);
+	ST7735S_EndPixels();
+	Expect(Frame[70][60] == Red && Frame[71][60] == Red && Frame[50][60] == Blue, "moved window keeps its columns");
+	Expect(Bytes == 11 + 6 + 4, "moved window bus bytes");
+
+	if (Failures) {
+		return EXIT_FAILURE;
+	}
+	printf("lcd: ok\n");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+# Feeds synthetic captures through tools/spectrum_stream.py: split reads,
+# command replies between frames, dropped sweeps, bad CRCs.
+
+import io
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+TOOL = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'tools', 'spectrum_stream.py')
+sys.path.insert(0, os.path.dirname(TOOL))
+import spectrum_stream
+
+
+def frame(seq, rssi, start=43000000, step=250, bins=1, time_ms=1000):
+	# Same layout as SendStreamFrame in app/spectrum.c
+	body = struct.pack('<HIIIHB', seq & 0xFFFF, time_ms, start, step, len(rssi), bins)
+	body += struct.pack('<%dH' % len(rssi), *rssi)
+	return b'\x55\xaa' + body + struct.pack('<H', spectrum_stream.crc16(body))
+
+
+def check(name, got, expected):
+	if got != expected:
+		print('spectrum_stream: %s: got %r, expected %r' % (name, got, expected))
+		sys.exit(1)
+
+
+def decode(chunks):
+	out = io.StringIO()
+	counts = spectrum_stream.decode(chunks, out)
+	return counts, out.getvalue()
+
+
+def main():
+	check('crc check value', spectrum_stream.crc16(b'123456789'), 0x29B1)
+	check('start command', spectrum_stream.start_command(43000000, 250, 128).hex(), '53c0209002fa00000080003f')
+
+	good = [frame(seq, [72 + seq + i for i in range(16)]) for seq in (0, 1, 2, 4)]
+	# Sync bytes inside the payload must not split the frame
+	good.append(frame(5, [0xAA55] * 16))
+	# 65535 -> 0 is not a drop
+	wrap = [frame(0xFFFF, [80] * 128), frame(0, [81] * 128)]
+	bad = bytearray(frame(3, [90] * 16))
+	bad[10] ^= 1
+
+	capture = b'\x55' + good[0] + good[1] + b'\x06' + good[2] + bytes(bad) + good[3] + b'\xff' + good[4]
+	capture += b'\x06' + wrap[0] + wrap[1] + b'\x55'
+
+	counts, csv = decode([capture])
+	# Sequences 0 1 2 4 5 65535 0: 3 fails its CRC, 6 to 65534 never arrived
+	check('frames', counts[0], 7)
+	check('dropped', counts[1], 1 + 65529)
+	# The trailing 0x55 is kept for the next read
+	check('skipped', counts[2], 1 + 1 + len(bad) + 1 + 1)
+	lines = csv.splitlines()
+	check('csv lines', len(lines), 7)
+	check('first line', lines[0], ','.join(str(v) for v in [0, 1000, 43000000, 250, 1] + [72 + i for i in range(16)]))
+	check('sync in payload', lines[4].split(',')[5:], ['43605'] * 16)
+	check('wide frame', len(lines[5].split(',')), 5 + 128)
+
+	# Serial reads cut the capture anywhere
+	for cut in range(1, len(capture)):
+		check('split at %d' % cut, decode([capture[:cut], capture[cut:]]), (counts, csv))
+	check('byte reads', decode([capture[i:i + 1] for i in range(len(capture))]), (counts, csv))
+
+	with tempfile.NamedTemporaryFile(suffix='.bin', delete=False) as f:
+		f.write(capture)
+	try:
+		result = subprocess.run([sys.executable, TOOL, f.name], capture_output=True, text=True)
+		check('cli exit', result.returncode, 0)
+		check('cli csv', result.stdout, csv)
+		with open(f.name, 'wb') as empty:
+			empty.write(b'\x06\xff')
+		result = subprocess.run([sys.executable, TOOL, f.name], capture_output=True, text=True)
+		check('cli empty exit', result.returncode, 1)
+	finally:
+		os.unlink(f.name)
+
+	print('spectrum_stream: ok')
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# Reference decoder for the spectrum UART stream.
+#
+# Start a stream and log it:  spectrum_stream.py /dev/ttyUSB0 --start 43000000 --step 2500 --count 128
+# Check a raw capture:        spectrum_stream.py capture.bin
+#
+# Frequencies are in 10 Hz units. Output is one CSV line per frame:
+# sequence,time_ms,start,step,bins_per_column,rssi...
+
+import argparse
+import struct
+import sys
+
+SYNC = b'\x55\xaa'
+HEADER = struct.Struct('<HIIIHB')
+
+
+def crc16(data):
+	crc = 0xFFFF
+	for b in data:
+		crc ^= b << 8
+		for _ in range(8):
+			crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+			crc &= 0xFFFF
+	return crc
+
+
+def start_command(start, step, count):
+	cmd = struct.pack('<BIIH', 0x53, start, step, count)
+	return cmd + bytes([sum(cmd) & 0xFF])
+
+
+def frames(data):
+	"""Yields (fields, rssi) for every frame with a valid CRC, and the number of bytes skipped."""
+	pos = 0
+	search = 0
+	skipped = 0
+	while True:
+		i = data.find(SYNC, search)
+		if i < 0:
+			# Keep a trailing 0x55, it may start the next frame
+			keep = max(pos, len(data) - 1)
+			return skipped + keep - pos, data[keep:]
+		if i + 2 + HEADER.size > len(data):
+			return skipped + i - pos, data[i:]
+		fields = HEADER.unpack_from(data, i + 2)
+		end = i + 2 + HEADER.size + fields[4] * 2
+		if end + 2 > len(data):
+			return skipped + i - pos, data[i:]
+		if fields[4] <= 128 and crc16(data[i + 2:end]) == struct.unpack_from('<H', data, end)[0]:
+			skipped += i - pos
+			yield fields, struct.unpack_from('<%dH' % fields[4], data, i + 2 + HEADER.size)
+			pos = search = end + 2
+		else:
+			search = i + 1
+
+
+def decode(chunks, out):
+	pending = b''
+	last = None
+	good = 0
+	dropped = 0
+	skipped = 0
+	for chunk in chunks:
+		gen = frames(pending + chunk)
+		while True:
+			try:
+				fields, rssi = next(gen)
+			except StopIteration as stop:
+				skip, pending = stop.value
+				skipped += skip
+				break
+			seq = fields[0]
+			if last is not None:
+				dropped += (seq - last - 1) & 0xFFFF
+			last = seq
+			good += 1
+			out.write(','.join(str(v) for v in fields[:4] + fields[5:] + tuple(rssi)) + '\n')
+	return good, dropped, skipped
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__)
+	parser.add_argument('source', help='serial port or raw capture file')
+	parser.add_argument('--start', type=int)
+	parser.add_argument('--step', type=int)
+	parser.add_argument('--count', type=int, help='16 - 1024, 0 stops the stream')
+	parser.add_argument('--baud', type=int, default=115200)
+	args = parser.parse_args()
+
+	if args.start is not None:
+		import serial
+		port = serial.Serial(args.source, args.baud)
+		port.write(start_command(args.start, args.step, args.count))
+		chunks = iter(lambda: port.read(port.in_waiting or 1), b'')
+	else:
+		with open(args.source, 'rb') as f:
+			chunks = [f.read()]
+
+	good, dropped, skipped = decode(chunks, sys.stdout)
+	sys.stderr.write('%d frames, %d dropped by the radio, %d bytes not in a valid frame\n' % (good, dropped, skipped))
+	return 0 if good else 1
+
+
+if __name__ == '__main__':
+	sys.exit(main())
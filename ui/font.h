@@ -20,6 +20,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+extern uint32_t gFontCacheHits;
+extern uint32_t gFontCacheMisses;
+
 void FONT_Draw(uint8_t X, uint8_t Y, const uint32_t *pOffsets, uint32_t Count);
 uint8_t FONT_GetOffsets(const char *String, uint8_t Size, bool bFlag);
 
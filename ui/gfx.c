@@ -30,24 +30,18 @@ uint16_t COLOR_GREY;
 
 void DISPLAY_FillColor(uint16_t Color)
 {
-	uint16_t i;
-
-	ST7735S_SetPosition(0, 0);
-	for (i = 0; i < (160 * 128); i++) {
-		ST7735S_SendU16(Color);
-	}
+	DISPLAY_Fill(0, 159, 0, 127, Color);
 }
 
 void DISPLAY_Fill(uint8_t X0, uint8_t X1, uint8_t Y0, uint8_t Y1, uint16_t Color)
 {
-	uint8_t y;
-
-	for (; X0 <= X1; X0++) {
-		ST7735S_SetPosition(X0, Y0);
-		for (y = Y0; y <= Y1; y++) {
-			ST7735S_SendU16(Color);
-		}
+	if (X0 > X1 || Y0 > Y1) {
+		return;
 	}
+	ST7735S_SetWindow(X0, X1, Y0, Y1);
+	ST7735S_BeginPixels();
+	ST7735S_PushPixels(Color, (X1 - X0 + 1) * (Y1 - Y0 + 1));
+	ST7735S_EndPixels();
 }
 
 void DISPLAY_DrawRectangle0(uint8_t X, uint8_t Y, uint8_t W, uint8_t H, uint16_t Color)
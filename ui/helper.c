@@ -26,6 +26,7 @@
 #include "misc.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "task/scanner.h"
 #include "ui/font.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
@@ -250,35 +251,47 @@ void UI_DrawString(uint8_t X, uint8_t Y, const char *pString, uint8_t Size)
 	FONT_Draw(X, Y, SFLASH_FontOffsets, FONT_GetOffsets(pString, Size, true));
 }
 
-void UI_DrawSmallCharacter(uint8_t X, uint8_t Y, char Digit)
+static uint8_t GetSmallFontIndex(char Digit)
 {
-	uint8_t Base;
-	uint8_t i;
-
-	Base = 0;
 #ifdef SMALL_CHARS_EXTENDED
 	if (Digit >= '-' && Digit <= 'z') {
 #else
 	if (Digit >= '-' && Digit <= 'Z') {
 #endif
-		Base = (Digit - '-') + 1;
+		return (Digit - '-') + 1;
 	}
+
+	return 0;
+}
+
+static void PushSmallCharacter(char Digit)
+{
+	const uint8_t *pColumns = FontSmall[GetSmallFontIndex(Digit)];
+	uint8_t i;
+
 	for (i = 0; i < 5; i++) {
-		uint8_t Pixel = FontSmall[Base][i];
+		uint8_t Pixel = pColumns[i];
 		uint8_t j;
 
-		ST7735S_SetPosition(X + i, Y);
 		for (j = 0; j < 8; j++) {
 			if (Pixel & 0x80U) {
-				ST7735S_SendU16(gColorForeground);
+				ST7735S_PushPixel(gColorForeground);
 			} else {
-				ST7735S_SendU16(gColorBackground);
+				ST7735S_PushPixel(gColorBackground);
 			}
 			Pixel <<= 1;
 		}
 	}
 }
 
+void UI_DrawSmallCharacter(uint8_t X, uint8_t Y, char Digit)
+{
+	ST7735S_SetWindow(X, X + 4, Y, Y + 7);
+	ST7735S_BeginPixels();
+	PushSmallCharacter(Digit);
+	ST7735S_EndPixels();
+}
+
 void UI_DrawDigits(const char *pDigits, uint8_t Vfo)
 {
 	uint8_t X;
@@ -302,9 +315,20 @@ void UI_DrawSmallString(uint8_t X, uint8_t Y, const char *String, uint8_t Size)
 {
 	uint8_t i;
 
+	if (Size == 0) {
+		return;
+	}
+
+	// One window per character so the gap column isn't sent, only the first sets the Y range.
+	ST7735S_SetWindow(X, X + 4, Y, Y + 7);
 	for (i = 0; i < Size; i++) {
-		UI_DrawSmallCharacter(X, Y, String[i]);
-		X += 6;
+		if (i) {
+			X += 6;
+			ST7735S_MoveWindowX(X, X + 4);
+		}
+		ST7735S_BeginPixels();
+		PushSmallCharacter(String[i]);
+		ST7735S_EndPixels();
 	}
 }
 
@@ -314,23 +338,25 @@ void UI_DrawStatusIcon(uint8_t X, UI_Icon_t Icon, bool bDraw, uint16_t Color)
 	const uint8_t Index = (Icon >> 8) & 0xFFU;
 	uint8_t i, j;
 
+	ST7735S_SetWindow(X, X + Size - 1, 85, 94);
+	ST7735S_BeginPixels();
 	for (i = 0; i < Size; i++) {
 		uint16_t Pixel = Icons[Index + i];
 
-		ST7735S_SetPosition(X + i, 85);
 		for (j = 0; j < 10; j++) {
 			if (bDraw) {
 				if (Pixel & 0x0200U) {
-					ST7735S_SendU16(Color);
+					ST7735S_PushPixel(Color);
 				} else {
-					ST7735S_SendU16(gColorBackground);
+					ST7735S_PushPixel(gColorBackground);
 				}
 				Pixel <<= 1;
 			} else {
-				ST7735S_SendU16(gColorBackground);
+				ST7735S_PushPixel(gColorBackground);
 			}
 		}
 	}
+	ST7735S_EndPixels();
 }
 
 void UI_DrawRoger(void)
@@ -526,19 +552,21 @@ void UI_DrawBigDigit(uint8_t X, uint8_t Y, uint8_t Digit)
 	uint8_t i;
 	uint8_t j;
 
+	ST7735S_SetWindow(X, X + 9, Y, Y + 13);
+	ST7735S_BeginPixels();
 	for (i = 0; i < 10; i++) {
 		uint16_t Pixel = FontBigDigits[Digit][i];
 
-		ST7735S_SetPosition(X + i, Y);
 		for (j = 0; j < 14; j++) {
 			if (Pixel & 0x2000U) {
-				ST7735S_SendU16(gColorForeground);
+				ST7735S_PushPixel(gColorForeground);
 			} else {
-				ST7735S_SendU16(gColorBackground);
+				ST7735S_PushPixel(gColorBackground);
 			}
 			Pixel <<= 1;
 		}
 	}
+	ST7735S_EndPixels();
 }
 
 void UI_DrawCss(uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool bMute, uint8_t Vfo)
@@ -654,6 +682,8 @@ void UI_DrawRX(uint8_t Vfo)
 	uint8_t i;
 	uint8_t j;
 
+	ST7735S_SetWindow(4, 13, 56 - (Vfo * 41), 67 - (Vfo * 41));
+	ST7735S_BeginPixels();
 	for (i = 0; i < 10; i++) {
 		uint16_t Pixel;
 
@@ -667,16 +697,16 @@ void UI_DrawRX(uint8_t Vfo)
 			gColorForeground = gColorBackground;
 			Pixel = 0x0FFF;
 		}
-		ST7735S_SetPosition(4 + i, 56 - (Vfo * 41));
 		for (j = 0; j < 12; j++) {
 			if (Pixel & 0x800U) {
-				ST7735S_SendU16(gColorForeground);
+				ST7735S_PushPixel(gColorForeground);
 			} else {
-				ST7735S_SendU16(gColorBackground);
+				ST7735S_PushPixel(gColorBackground);
 			}
 			Pixel <<= 1;
 		}
 	}
+	ST7735S_EndPixels();
 
 }
 
@@ -715,18 +745,21 @@ void UI_DrawBitmap(uint8_t X, uint8_t Y, uint8_t H, uint8_t W, const uint8_t *pB
 	uint8_t x, y, i;
 
 	for (y = 0; y < H; y++) {
+		ST7735S_SetWindow(X, X + W - 1, Y, Y + 7);
+		ST7735S_BeginPixels();
 		for (x = 0; x < W; x++) {
 			uint8_t Pixel = pBitmap[x + (y * W)];
 
 			for (i = 0; i < 8; i++) {
 				if (Pixel & 0x80U) {
-					ST7735S_SetPixel(X + x, Y + i, gColorForeground);
+					ST7735S_PushPixel(gColorForeground);
 				} else {
-					ST7735S_SetPixel(X + x, Y + i, gColorBackground);
+					ST7735S_PushPixel(gColorBackground);
 				}
 				Pixel <<= 1;
 			}
 		}
+		ST7735S_EndPixels();
 		Y += 8;
 	}
 }
@@ -745,12 +778,48 @@ void UI_DrawDialog(void)
 	UI_DrawFrame(4, 156, 19, 40, 2, gSettings.BorderColor);
 }
 
-void UI_DrawBar(uint8_t Level, uint8_t Vfo)
+static uint8_t BarLevel[2] = { BAR_LEVEL_UNKNOWN, BAR_LEVEL_UNKNOWN };
+
+static uint8_t GetBarZone(uint8_t Level)
 {
-	uint8_t Y = 44 - (Vfo * 41);
-	uint8_t i;
+	if (Level < 33) {
+		return 0;
+	}
+	if (Level < 66) {
+		return 1;
+	}
+
+	return 2;
+}
 
-    if (Level < 33) {
+// Columns 0, 33, 66 and 99 are the scale gaps and are never painted.
+static void DrawBarColumns(uint8_t X, uint8_t Y, uint8_t From, uint8_t To, uint16_t Color)
+{
+	while (From < To) {
+		uint8_t End;
+
+		if ((From % 33) == 0) {
+			From++;
+			continue;
+		}
+		End = ((From / 33) + 1) * 33;
+		if (End > To) {
+			End = To;
+		}
+		DISPLAY_Fill(X + From, X + End - 1, Y, Y + 3, Color);
+		From = End;
+	}
+}
+
+void UI_DrawLevelBar(uint8_t X, uint8_t Y, uint8_t Level, uint8_t *pLastLevel)
+{
+	const uint8_t LastLevel = *pLastLevel;
+
+	if (Level > 100) {
+		Level = 100;
+	}
+
+	if (Level < 33) {
 		gColorForeground = COLOR_RGB(31, 62,  0);
 	} else if (Level < 66) {
 		gColorForeground = COLOR_RGB(31, 41,  0);
@@ -758,17 +827,31 @@ void UI_DrawBar(uint8_t Level, uint8_t Vfo)
 		gColorForeground = COLOR_RGB(31, 29,  0);
 	}
 
-	for (i = 0; i < Level; i++) {
-	if (i != 0 && i != 33 && i != 66 && i != 99) {
-			DISPLAY_DrawRectangle1(20 + i, Y, 4, 1, gColorForeground);
-		}
+	if (LastLevel == BAR_LEVEL_UNKNOWN) {
+		DrawBarColumns(X, Y, 0, Level, gColorForeground);
+		DrawBarColumns(X, Y, Level, 100, gColorBackground);
+	} else if (GetBarZone(Level) != GetBarZone(LastLevel)) {
+		// The whole bar takes the colour of the zone the level is in.
+		DrawBarColumns(X, Y, 0, Level, gColorForeground);
+		DrawBarColumns(X, Y, Level, LastLevel, gColorBackground);
+	} else if (Level > LastLevel) {
+		DrawBarColumns(X, Y, LastLevel, Level, gColorForeground);
+	} else {
+		DrawBarColumns(X, Y, Level, LastLevel, gColorBackground);
 	}
 
-    for (; Level < 100; Level++) {
-		if (Level != 0 && Level != 33 && Level != 66 && Level != 99) {
-			DISPLAY_DrawRectangle1(20 + Level, Y, 4, 1, gColorBackground);
-		}
-	}
+	*pLastLevel = Level;
+}
+
+void UI_DrawBar(uint8_t Level, uint8_t Vfo)
+{
+	UI_DrawLevelBar(20, 44 - (Vfo * 41), Level, &BarLevel[Vfo]);
+}
+
+void UI_InvalidateBars(void)
+{
+	BarLevel[0] = BAR_LEVEL_UNKNOWN;
+	BarLevel[1] = BAR_LEVEL_UNKNOWN;
 }
 
 void UI_DrawSomething(void)
@@ -807,23 +890,25 @@ void UI_DrawMainBitmap(bool bOverride, uint8_t Vfo)
 		gColorForeground = COLOR_FOREGROUND;
 	}
 
+	ST7735S_SetWindow(4, 15, 68 - (Vfo * 41), 77 - (Vfo * 41));
+	ST7735S_BeginPixels();
 	for (i = 0; i < 12; i++) {
 		uint16_t Pixel = BitmapMAIN[i];
 
-		ST7735S_SetPosition(i + 4, 68 - (Vfo * 41));
 		for (j = 0; j < 10; j++) {
 			if (bOverride) {
 				if (Pixel & 0x0200U) {
-					ST7735S_SendU16(gColorForeground);
+					ST7735S_PushPixel(gColorForeground);
 				} else {
-					ST7735S_SendU16(gColorBackground);
+					ST7735S_PushPixel(gColorBackground);
 				}
 				Pixel <<= 1;
 			} else {
-				ST7735S_SendU16(gColorBackground);
+				ST7735S_PushPixel(gColorBackground);
 			}
 		}
 	}
+	ST7735S_EndPixels();
 }
 
 void UI_DrawSky(void)
@@ -1014,16 +1099,24 @@ void UI_DrawScan(void)
 	if (!gScannerMode) {
 		UI_DrawSmallString(58, 86, "        ", 8);
 	} else {
+		// List, then channels per second: "L1  15/s"
+		char String[8] = "      /s";
+
 		if (gSettings.WorkMode) {
-UI_DrawSmallString(58, 86, gExtendedSettings.ScanAll ? "SCAN ALL" :
-									   gExtendedSettings.CurrentScanList == 0 ? "SCAN L1 " :
-									   gExtendedSettings.CurrentScanList == 1 ? "SCAN L2 " :
-									   gExtendedSettings.CurrentScanList == 2 ? "SCAN L3 " :
-									   gExtendedSettings.CurrentScanList == 3 ? "SCAN L4 " :
-									   gExtendedSettings.CurrentScanList == 4 ? "SCAN L5 " :
-									   gExtendedSettings.CurrentScanList == 5 ? "SCAN L6 " :
-									   gExtendedSettings.CurrentScanList == 6 ? "SCAN L7 " : "SCAN L8 ", 8);
+			if (gExtendedSettings.ScanAll) {
+				String[0] = 'A';
+				String[1] = 'L';
+				String[2] = 'L';
+			} else {
+				String[0] = 'L';
+				String[1] = '1' + gExtendedSettings.CurrentScanList;
+			}
 		}
+		Int2Ascii(SCANNER_HopRate > 999 ? 999 : SCANNER_HopRate, 3);
+		String[3] = gShortString[0] == '0' ? ' ' : gShortString[0];
+		String[4] = (String[3] == ' ' && gShortString[1] == '0') ? ' ' : gShortString[1];
+		String[5] = gShortString[2];
+		UI_DrawSmallString(58, 86, String, 8);
 	}
 }
 
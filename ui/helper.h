@@ -32,6 +32,8 @@ enum UI_Icon_t {
 
 typedef enum UI_Icon_t UI_Icon_t;
 
+#define BAR_LEVEL_UNKNOWN 0xFFU
+
 void UI_DrawString(uint8_t X, uint8_t Y, const char *String, uint8_t Size);
 void UI_DrawSmallCharacter(uint8_t X, uint8_t Y, char Digit);
 void UI_DrawDigits(const char *pDigits, uint8_t Vfo);
@@ -56,7 +58,9 @@ void UI_DrawFM(void);
 void UI_DrawBitmap(uint8_t X,uint8_t Y, uint8_t H, uint8_t W, const uint8_t *pBitmap);
 void UI_DrawFrame(uint8_t X0, uint8_t X1, uint8_t Y0, uint8_t Y1, uint8_t Thickness, uint16_t Color);
 void UI_DrawDialog(void);
+void UI_DrawLevelBar(uint8_t X, uint8_t Y, uint8_t Level, uint8_t *pLastLevel);
 void UI_DrawBar(uint8_t Level, uint8_t Vfo);
+void UI_InvalidateBars(void);
 void UI_DrawSomething(void);
 void UI_DrawMainBitmap(bool bOverride, uint8_t Vfo);
 void UI_DrawSky(void);
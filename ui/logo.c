@@ -26,7 +26,9 @@ static void DrawImage(uint32_t Address)
 	uint16_t i;
 	uint8_t X = 0;
 	uint8_t Y = 0;
+	bool bRun = false;
 
+	// Black pixels are transparent, the others are streamed in runs along X.
 	for (i = 0; i < 0x7800; i += 2) {
 		uint16_t Color;
 
@@ -35,10 +37,22 @@ static void DrawImage(uint32_t Address)
 		}
 		Color = (gFlashBuffer[i & 0x1FFF] << 8) | gFlashBuffer[(i + 1) & 0x1FFF];
 		if (Color != 0) {
-			ST7735S_SetPixel(X, Y, Color);
+			if (!bRun) {
+				ST7735S_SetWindow(X, 159, Y, Y);
+				ST7735S_BeginPixels();
+				bRun = true;
+			}
+			ST7735S_PushPixel(Color);
+		} else if (bRun) {
+			ST7735S_EndPixels();
+			bRun = false;
 		}
 		X++;
 		if (X == 160) {
+			if (bRun) {
+				ST7735S_EndPixels();
+				bRun = false;
+			}
 			X = 0;
 			Y++;
 		}
@@ -24,9 +24,17 @@
 #include "ui/helper.h"
 #include "ui/main.h"
 #include "ui/vfo.h"
+#ifdef UART_DEBUG
+	#include "driver/st7735s.h"
+	#include "driver/uart.h"
+#endif
 
 void DrawStatusBar(void)
 {
+#ifdef UART_DEBUG
+	const uint32_t LcdBytes = gLcdBusBytes;
+#endif
+
 	DISPLAY_Fill(0, 159, 0, 96, COLOR_BACKGROUND);
 	//DISPLAY_DrawRectangle0(0, 82, 160, 1, gSettings.BorderColor);
 	DISPLAY_DrawRectangle0(0, 82, 160, 1, COLOR_GREY);
@@ -84,6 +92,10 @@ void DrawStatusBar(void)
 	UI_DrawRepeaterMode();
 	UI_DrawStatusIcon(139, ICON_BATTERY, true, COLOR_GREY);
 	UI_DrawBattery();
+
+#ifdef UART_DEBUG
+	UART_printf("DrawStatusBar LCD bytes: %u\r\n", (unsigned int)(gLcdBusBytes - LcdBytes));
+#endif
 }
 
 void UI_DrawMain(bool bSkipStatus)
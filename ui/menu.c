@@ -97,20 +97,21 @@ void UI_DrawSettingArrow(uint8_t Selection)
 	DISPLAY_Fill(8, 16,  8, 23, COLOR_BACKGROUND);
 	DISPLAY_Fill(1, 16, 32, 47, COLOR_BACKGROUND);
 
+	ST7735S_SetWindow(8, 13, 32 - (Selection * 24), 47 - (Selection * 24));
+	ST7735S_BeginPixels();
 	for (i = 0; i < 6; i++) {
 		uint16_t Pixel = Bitmap[i];
 
-		ST7735S_SetPosition(8 + i, 32 - (Selection * 24));
-
 		for (j = 0; j < 16; j++) {
 			if (Pixel & 0x8000U) {
-				ST7735S_SendU16(COLOR_FOREGROUND);
+				ST7735S_PushPixel(COLOR_FOREGROUND);
 			} else {
-				ST7735S_SendU16(gColorBackground);
+				ST7735S_PushPixel(gColorBackground);
 			}
 			Pixel <<= 1;
 		}
 	}
+	ST7735S_EndPixels();
 }
 
 void UI_DrawDtmfInterval(uint8_t Interval)
@@ -189,6 +190,7 @@ void UI_DrawActions(uint8_t Index)
 		"Bandwidth    ",
 		"TX CTCSS/DCS ",
 		"TX Priority  ",
+		"Lockout Freq ",
 	};
 
 	UI_DrawSettingOptionEx(Actions[Index], 13, 0);
@@ -496,6 +498,19 @@ void UI_DrawSettingScanlist(uint8_t Index)
 	UI_DrawSettingOptionEx(Mode[(Index + 1) % 9], 8, 1);
 }
 
+void UI_DrawSettingPriorityScan(uint8_t Index)
+{
+	static const char Mode[4][8] = {
+			"Off     ",
+			"Every 1s",
+			"Every 2s",
+			"Every 5s",
+	};
+
+	UI_DrawSettingOptionEx(Mode[Index], 8, 0);
+	UI_DrawSettingOptionEx(Mode[(Index + 1) % 4], 8, 1);
+}
+
 void UI_DrawSettingMicGain(uint8_t Index)
 {
 	gColorForeground = COLOR_FOREGROUND;
@@ -35,6 +35,8 @@ static void DrawBandwidth(bool bIsNarrow, uint8_t Vfo)
 
 void UI_DrawVfo(uint8_t Vfo)
 {
+	// The VFO area may have been cleared, the next RSSI bar has to be drawn in full.
+	UI_InvalidateBars();
 	UI_DrawName(Vfo, gVfoState[Vfo].Name);
 	gColorForeground = COLOR_FOREGROUND;
 	UI_DrawVfoFrame(Vfo);